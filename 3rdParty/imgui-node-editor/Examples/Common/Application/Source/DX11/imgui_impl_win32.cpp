@@ -79,6 +79,8 @@ bool    ImGui_ImplWin32_Init(void* hwnd)
     io.KeyMap[ImGuiKey_X] = 'X';
     io.KeyMap[ImGuiKey_Y] = 'Y';
     io.KeyMap[ImGuiKey_Z] = 'Z';
+    io.KeyMap[ImGuiKey_O] = 'O';
+    io.KeyMap[ImGuiKey_S] = 'S';
 
     return true;
 }
@@ -326,6 +326,8 @@ bool    ImGui_ImplGlfwGL3_Init(GLFWwindow* window, bool install_callbacks)
     io.KeyMap[ImGuiKey_Y] = GLFW_KEY_Y;
     io.KeyMap[ImGuiKey_Z] = GLFW_KEY_Z;
     io.KeyMap[ImGuiKey_F] = GLFW_KEY_F;
+    io.KeyMap[ImGuiKey_O] = GLFW_KEY_O;
+    io.KeyMap[ImGuiKey_S] = GLFW_KEY_S;
 
     io.RenderDrawListsFn = ImGui_ImplGlfwGL3_RenderDrawLists;       // Alternatively you can set this to NULL and call ImGui::GetDrawData() after ImGui::Render() to get the same ImDrawData pointer.
 #ifdef _WIN32
@@ -2,6 +2,14 @@
 # include "imgui_canvas.h"
 # include <type_traits>
 
+// SSE2 is part of every x64 target, 32-bit builds get it only when asked for
+# if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#     define IMGUI_EX_CANVAS_SSE2() 1
+#     include <emmintrin.h>
+# else
+#     define IMGUI_EX_CANVAS_SSE2() 0
+# endif
+
 // https://stackoverflow.com/a/36079786
 # define DECLARE_HAS_MEMBER(__trait_name__, __member_name__)                         \
                                                                                      \
@@ -49,6 +57,48 @@ struct FringeScaleRef
 
 } // namespace ImCanvasDetails
 
+void ImGuiEx::TransformVertices(ImDrawVert* vertex, ImDrawVert* vertexEnd, float scale, const ImVec2& offset)
+{
+# if IMGUI_EX_CANVAS_SSE2()
+    // ImDrawVert is 20 bytes, positions of two vertices are gathered into one register
+    const __m128 scale4  = _mm_set1_ps(scale);
+    const __m128 offset4 = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+    for (; vertexEnd - vertex >= 4; vertex += 4)
+    {
+        __m128 a = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&vertex[0].pos)), reinterpret_cast<const __m64*>(&vertex[1].pos));
+        __m128 b = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&vertex[2].pos)), reinterpret_cast<const __m64*>(&vertex[3].pos));
+        a = _mm_add_ps(_mm_mul_ps(a, scale4), offset4);
+        b = _mm_add_ps(_mm_mul_ps(b, scale4), offset4);
+        _mm_storel_pi(reinterpret_cast<__m64*>(&vertex[0].pos), a);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(&vertex[1].pos), a);
+        _mm_storel_pi(reinterpret_cast<__m64*>(&vertex[2].pos), b);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(&vertex[3].pos), b);
+    }
+# endif
+
+    TransformVerticesScalar(vertex, vertexEnd, scale, offset);
+}
+
+void ImGuiEx::TransformVerticesScalar(ImDrawVert* vertex, ImDrawVert* vertexEnd, float scale, const ImVec2& offset)
+{
+    if (scale != 1.0f)
+    {
+        for (; vertex < vertexEnd; ++vertex)
+        {
+            vertex->pos.x = vertex->pos.x * scale + offset.x;
+            vertex->pos.y = vertex->pos.y * scale + offset.y;
+        }
+    }
+    else
+    {
+        for (; vertex < vertexEnd; ++vertex)
+        {
+            vertex->pos.x = vertex->pos.x + offset.x;
+            vertex->pos.y = vertex->pos.y + offset.y;
+        }
+    }
+}
+
 // Returns a reference to _FringeScale extension to ImDrawList
 //
 // If ImDrawList does not have _FringeScale a placeholder is returned.
@@ -417,16 +467,11 @@ void ImGuiEx::Canvas::LeaveLocalSpace()
     auto vertex    = m_DrawList->VtxBuffer.Data + m_DrawListStartVertexIndex;
     auto vertexEnd = m_DrawList->VtxBuffer.Data + m_DrawList->_VtxCurrentIdx;
 
+    TransformVertices(vertex, vertexEnd, m_View.Scale, m_ViewTransformPosition);
+
     // If canvas view is not scaled take a faster path.
     if (m_View.Scale != 1.0f)
     {
-        while (vertex < vertexEnd)
-        {
-            vertex->pos.x = vertex->pos.x * m_View.Scale + m_ViewTransformPosition.x;
-            vertex->pos.y = vertex->pos.y * m_View.Scale + m_ViewTransformPosition.y;
-            ++vertex;
-        }
-
         // Move clip rectangles to screen space.
         for (int i = m_DrawListCommadBufferSize; i < m_DrawList->CmdBuffer.size(); ++i)
         {
@@ -439,13 +484,6 @@ void ImGuiEx::Canvas::LeaveLocalSpace()
     }
     else
     {
-        while (vertex < vertexEnd)
-        {
-            vertex->pos.x = vertex->pos.x + m_ViewTransformPosition.x;
-            vertex->pos.y = vertex->pos.y + m_ViewTransformPosition.y;
-            ++vertex;
-        }
-
         // Move clip rectangles to screen space.
         for (int i = m_DrawListCommadBufferSize; i < m_DrawList->CmdBuffer.size(); ++i)
         {
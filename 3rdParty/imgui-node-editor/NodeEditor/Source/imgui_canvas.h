@@ -71,6 +71,16 @@ struct CanvasView
     }
 };
 
+// Moves vertices from canvas to screen space: pos * scale + offset.
+//
+// Uses SSE2 when the target has it. SIMD path does the very same multiply and
+// add per component, results are bit-identical to TransformVerticesScalar().
+void TransformVertices(ImDrawVert* vertex, ImDrawVert* vertexEnd, float scale, const ImVec2& offset);
+
+// Plain per-vertex loop, reference for TransformVertices() and its fallback
+// where SSE2 is not available.
+void TransformVerticesScalar(ImDrawVert* vertex, ImDrawVert* vertexEnd, float scale, const ImVec2& offset);
+
 // Canvas widget represent view over infinite plane.
 //
 // It acts like a child window without scroll bars with
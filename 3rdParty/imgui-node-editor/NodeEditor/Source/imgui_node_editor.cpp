@@ -9,6 +9,7 @@
 //------------------------------------------------------------------------------
 # include "imgui_node_editor_internal.h"
 # include <cstdio> // snprintf
+# include <cstring> // memcmp
 # include <string>
 # include <fstream>
 # include <bitset>
@@ -441,7 +442,7 @@ static void ImDrawList_PolyFillScanFlood(ImDrawList *draw, std::vector<ImVec2>*
 
 static void ImDrawList_AddBezierWithArrows(ImDrawList* drawList, const ImCubicBezierPoints& curve, float thickness,
     float startArrowSize, float startArrowWidth, float endArrowSize, float endArrowWidth,
-    bool fill, ImU32 color, float strokeThickness)
+    bool fill, ImU32 color, float strokeThickness, const ImVector<ImVec2>* polyline = nullptr)
 {
     using namespace ax;
 
@@ -452,7 +453,10 @@ static void ImDrawList_AddBezierWithArrows(ImDrawList* drawList, const ImCubicBe
 
     if (fill)
     {
-        drawList->AddBezierCurve(curve.P0, curve.P1, curve.P2, curve.P3, color, thickness);
+        if (polyline)
+            drawList->AddPolyline(polyline->Data, polyline->Size, color, false, thickness);
+        else
+            drawList->AddBezierCurve(curve.P0, curve.P1, curve.P2, curve.P3, color, thickness);
 
         if (startArrowSize > 0.0f)
         {
@@ -847,14 +851,12 @@ void ed::Link::Draw(ImDrawList* drawList, ImU32 color, float extraThickness) con
     if (!m_IsLive)
         return;
 
-    const auto curve = GetCurve();
-
-    ImDrawList_AddBezierWithArrows(drawList, curve, m_Thickness + extraThickness,
+    ImDrawList_AddBezierWithArrows(drawList, m_Curve, m_Thickness + extraThickness,
         m_StartPin && m_StartPin->m_ArrowSize  > 0.0f ? m_StartPin->m_ArrowSize  + extraThickness : 0.0f,
         m_StartPin && m_StartPin->m_ArrowWidth > 0.0f ? m_StartPin->m_ArrowWidth + extraThickness : 0.0f,
           m_EndPin &&   m_EndPin->m_ArrowSize  > 0.0f ?   m_EndPin->m_ArrowSize  + extraThickness : 0.0f,
           m_EndPin &&   m_EndPin->m_ArrowWidth > 0.0f ?   m_EndPin->m_ArrowWidth + extraThickness : 0.0f,
-        true, color, 1.0f);
+        true, color, 1.0f, &GetPolyline(drawList));
 }
 
 void ed::Link::UpdateEndpoints()
@@ -862,9 +864,45 @@ void ed::Link::UpdateEndpoints()
     const auto line = m_StartPin->GetClosestLine(m_EndPin);
     m_Start = line.A;
     m_End   = line.B;
+
+    Geometry geometry;
+    geometry.Start          = m_Start;
+    geometry.End            = m_End;
+    geometry.StartDir       = m_StartPin->m_Dir;
+    geometry.EndDir         = m_EndPin->m_Dir;
+    geometry.StartStrength  = m_StartPin->m_Strength;
+    geometry.EndStrength    = m_EndPin->m_Strength;
+    geometry.StartArrowSize = m_StartPin->m_ArrowSize;
+    geometry.EndArrowSize   = m_EndPin->m_ArrowSize;
+
+    // Fields are all floats, there is no padding to compare
+    if (memcmp(&geometry, &m_Geometry, sizeof(Geometry)) == 0 && !ImRect_IsEmpty(m_CurveBounds))
+        return;
+
+    m_Geometry    = geometry;
+    m_Curve       = BuildCurve();
+    m_CurveBounds = BuildBounds();
+    m_Polyline.resize(0);
+}
+
+const ImVector<ImVec2>& ed::Link::GetPolyline(ImDrawList* drawList) const
+{
+    const auto tolerance = drawList->_Data->CurveTessellationTol;
+    if (m_Polyline.Size > 0 && m_PolylineTolerance == tolerance)
+        return m_Polyline;
+
+    // Tessellated the same way ImDrawList::AddBezierCurve does, through the draw list's path
+    drawList->PathClear();
+    drawList->PathLineTo(m_Curve.P0);
+    drawList->PathBezierCurveTo(m_Curve.P1, m_Curve.P2, m_Curve.P3, 0);
+    m_Polyline.swap(drawList->_Path);
+    drawList->PathClear();
+    m_PolylineTolerance = tolerance;
+
+    return m_Polyline;
 }
 
-ImCubicBezierPoints ed::Link::GetCurve() const
+ImCubicBezierPoints ed::Link::BuildCurve() const
 {
     auto easeLinkStrength = [](const ImVec2& a, const ImVec2& b, float strength)
     {
@@ -905,7 +943,7 @@ bool ed::Link::TestHit(const ImVec2& point, float extraThickness) const
     if (!bounds.Contains(point))
         return false;
 
-    const auto bezier = GetCurve();
+    const auto& bezier = m_Curve;
     const auto result = ImProjectOnCubicBezier(point, bezier.P0, bezier.P1, bezier.P2, bezier.P3, 50);
 
     return result.Distance <= m_Thickness + extraThickness;
@@ -924,7 +962,7 @@ bool ed::Link::TestHit(const ImRect& rect, bool allowIntersect) const
     if (!allowIntersect || !rect.Overlaps(bounds))
         return false;
 
-    const auto bezier = GetCurve();
+    const auto& bezier = m_Curve;
 
     const auto p0 = rect.GetTL();
     const auto p1 = rect.GetTR();
@@ -945,49 +983,49 @@ bool ed::Link::TestHit(const ImRect& rect, bool allowIntersect) const
 
 ImRect ed::Link::GetBounds() const
 {
-    if (m_IsLive)
-    {
-        const auto curve = GetCurve();
-        auto bounds = ImCubicBezierBoundingRect(curve.P0, curve.P1, curve.P2, curve.P3);
+    return m_IsLive ? m_CurveBounds : ImRect();
+}
 
-        if (bounds.GetWidth() == 0.0f)
-        {
-            bounds.Min.x -= 0.5f;
-            bounds.Max.x += 0.5f;
-        }
+ImRect ed::Link::BuildBounds() const
+{
+    const auto& curve = m_Curve;
+    auto bounds = ImCubicBezierBoundingRect(curve.P0, curve.P1, curve.P2, curve.P3);
 
-        if (bounds.GetHeight() == 0.0f)
-        {
-            bounds.Min.y -= 0.5f;
-            bounds.Max.y += 0.5f;
-        }
+    if (bounds.GetWidth() == 0.0f)
+    {
+        bounds.Min.x -= 0.5f;
+        bounds.Max.x += 0.5f;
+    }
 
-        if (m_StartPin->m_ArrowSize)
-        {
-            const auto start_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 0.0f));
-            const auto p0 = curve.P0;
-            const auto p1 = curve.P0 - start_dir * m_StartPin->m_ArrowSize;
-            const auto min = ImMin(p0, p1);
-            const auto max = ImMax(p0, p1);
-            auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
-            bounds.Add(arrowBounds);
-        }
+    if (bounds.GetHeight() == 0.0f)
+    {
+        bounds.Min.y -= 0.5f;
+        bounds.Max.y += 0.5f;
+    }
 
-        if (m_EndPin->m_ArrowSize)
-        {
-            const auto end_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 1.0f));
-            const auto p0 = curve.P3;
-            const auto p1 = curve.P3 + end_dir * m_EndPin->m_ArrowSize;
-            const auto min = ImMin(p0, p1);
-            const auto max = ImMax(p0, p1);
-            auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
-            bounds.Add(arrowBounds);
-        }
+    if (m_StartPin->m_ArrowSize)
+    {
+        const auto start_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 0.0f));
+        const auto p0 = curve.P0;
+        const auto p1 = curve.P0 - start_dir * m_StartPin->m_ArrowSize;
+        const auto min = ImMin(p0, p1);
+        const auto max = ImMax(p0, p1);
+        auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
+        bounds.Add(arrowBounds);
+    }
 
-        return bounds;
+    if (m_EndPin->m_ArrowSize)
+    {
+        const auto end_dir = ImNormalized(ImCubicBezierTangent(curve.P0, curve.P1, curve.P2, curve.P3, 1.0f));
+        const auto p0 = curve.P3;
+        const auto p1 = curve.P3 + end_dir * m_EndPin->m_ArrowSize;
+        const auto min = ImMin(p0, p1);
+        const auto max = ImMax(p0, p1);
+        auto arrowBounds = ImRect(min, ImMax(max, min + ImVec2(1, 1)));
+        bounds.Add(arrowBounds);
     }
-    else
-        return ImRect();
+
+    return bounds;
 }
 
 
@@ -1113,6 +1151,8 @@ void ed::EditorContext::Begin(const char* id, const ImVec2& size)
 void ed::EditorContext::End()
 {
     //auto& io          = ImGui::GetIO();
+    UpdateSpatialIndex();
+
     auto  control     = BuildControl(m_CurrentAction && m_CurrentAction->IsDragging()); // NavigateAction.IsMovingOverEdge()
     auto  drawList    = ImGui::GetWindowDrawList();
     //auto& editorStyle = GetStyle();
@@ -1228,20 +1268,26 @@ void ed::EditorContext::End()
     {
         if (!IsGroup(control.ActiveNode))
         {
-            // Bring active node to front
-            auto activeNodeIt = std::find(m_Nodes.begin(), m_Nodes.end(), control.ActiveNode);
-            std::rotate(activeNodeIt, activeNodeIt + 1, m_Nodes.end());
+            // Bring active node to front, only the nodes it passes over move
+            if (m_Nodes.back().m_Object != control.ActiveNode)
+            {
+                auto activeNodeIt = FindNodeInZOrder(control.ActiveNode);
+                std::rotate(activeNodeIt, activeNodeIt + 1, m_Nodes.end());
+                UpdateZOrder(activeNodeIt);
+            }
         }
         else if (!isDragging && m_CurrentAction && m_CurrentAction->AsDrag())
         {
             // Bring content of dragged group to front
             std::vector<Node*> nodes;
             control.ActiveNode->GetGroupedNodes(nodes);
+            std::sort(nodes.begin(), nodes.end());
 
             std::stable_partition(m_Nodes.begin(), m_Nodes.end(), [&nodes](Node* node)
             {
-                return std::find(nodes.begin(), nodes.end(), node) == nodes.end();
+                return !std::binary_search(nodes.begin(), nodes.end(), node);
             });
+            UpdateZOrder(m_Nodes.begin());
 
             sortGroups = true;
         }
@@ -1250,11 +1296,7 @@ void ed::EditorContext::End()
     // Sort nodes if bounds of node changed
     if (sortGroups || ((m_Settings.m_DirtyReason & (SaveReasonFlags::Position | SaveReasonFlags::Size)) != SaveReasonFlags::None))
     {
-        // Bring all groups before regular nodes
-        auto groupsItEnd = std::stable_partition(m_Nodes.begin(), m_Nodes.end(), IsGroup);
-
-        // Sort groups by area
-        std::sort(m_Nodes.begin(), groupsItEnd, [this](Node* lhs, Node* rhs)
+        auto compareGroups = [this](Node* lhs, Node* rhs)
         {
             const auto& lhsSize = lhs == m_SizeAction.m_SizedNode ? m_SizeAction.GetStartGroupBounds().GetSize() : lhs->m_GroupBounds.GetSize();
             const auto& rhsSize = rhs == m_SizeAction.m_SizedNode ? m_SizeAction.GetStartGroupBounds().GetSize() : rhs->m_GroupBounds.GetSize();
@@ -1263,46 +1305,66 @@ void ed::EditorContext::End()
             const auto rhsArea = rhsSize.x * rhsSize.y;
 
             return lhsArea > rhsArea;
-        });
+        };
+
+        // Moving nodes around rarely breaks the order, it's only restored when it did
+        auto groupsItEnd = std::find_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return !IsGroup(node); });
+        if (std::find_if(groupsItEnd, m_Nodes.end(), IsGroup) != m_Nodes.end())
+        {
+            // Bring all groups before regular nodes
+            groupsItEnd = std::stable_partition(groupsItEnd, m_Nodes.end(), IsGroup);
+            UpdateZOrder(m_Nodes.begin());
+        }
+
+        // Sort groups by area
+        if (!std::is_sorted(m_Nodes.begin(), groupsItEnd, compareGroups))
+        {
+            std::sort(m_Nodes.begin(), groupsItEnd, compareGroups);
+            UpdateZOrder(m_Nodes.begin());
+        }
     }
 
 # if 1
-    // Every node has few channels assigned. Grow channel list
-    // to hold twice as much of channels and place them in
+    // Every node has few channels assigned. Place them in
     // node drawing order.
     {
-        // Copy group nodes
-        auto liveNodeCount = static_cast<int>(std::count_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return node->m_IsLive; }));
+        auto groupsItEnd = std::find_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return !IsGroup(node); });
+        auto hasLiveGroups = std::any_of(m_Nodes.begin(), groupsItEnd, [](Node* node) { return node->m_IsLive; });
 
-        // Reserve two additional channels for sorted list of channels
-        auto nodeChannelCount = drawList->_Splitter._Count;
-        ImDrawList_ChannelsGrow(drawList, drawList->_Splitter._Count + c_ChannelsPerNode * liveNodeCount + c_LinkChannelCount);
+        if (hasLiveGroups || !SortNodeChannelsInPlace(drawList))
+        {
+            // Groups have to go below links, which sit below all node channels.
+            // Grow channel list to hold twice as much of channels and copy everything in order.
+            auto liveNodeCount = static_cast<int>(std::count_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return node->m_IsLive; }));
 
-        int targetChannel = nodeChannelCount;
+            // Reserve two additional channels for sorted list of channels
+            auto nodeChannelCount = drawList->_Splitter._Count;
+            ImDrawList_ChannelsGrow(drawList, drawList->_Splitter._Count + c_ChannelsPerNode * liveNodeCount + c_LinkChannelCount);
 
-        auto copyNode = [&targetChannel, drawList](Node* node)
-        {
-            if (!node->m_IsLive)
-                return;
+            int targetChannel = nodeChannelCount;
 
-            for (int i = 0; i < c_ChannelsPerNode; ++i)
-                ImDrawList_SwapChannels(drawList, node->m_Channel + i, targetChannel + i);
+            auto copyNode = [&targetChannel, drawList](Node* node)
+            {
+                if (!node->m_IsLive)
+                    return;
 
-            node->m_Channel = targetChannel;
-            targetChannel += c_ChannelsPerNode;
-        };
+                for (int i = 0; i < c_ChannelsPerNode; ++i)
+                    ImDrawList_SwapChannels(drawList, node->m_Channel + i, targetChannel + i);
 
-        auto groupsItEnd = std::find_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return !IsGroup(node); });
+                node->m_Channel = targetChannel;
+                targetChannel += c_ChannelsPerNode;
+            };
 
-        // Copy group nodes
-        std::for_each(m_Nodes.begin(), groupsItEnd, copyNode);
+            // Copy group nodes
+            std::for_each(m_Nodes.begin(), groupsItEnd, copyNode);
 
-        // Copy links
-        for (int i = 0; i < c_LinkChannelCount; ++i, ++targetChannel)
-            ImDrawList_SwapChannels(drawList, c_LinkStartChannel + i, targetChannel);
+            // Copy links
+            for (int i = 0; i < c_LinkChannelCount; ++i, ++targetChannel)
+                ImDrawList_SwapChannels(drawList, c_LinkStartChannel + i, targetChannel);
 
-        // Copy normal nodes
-        std::for_each(groupsItEnd, m_Nodes.end(), copyNode);
+            // Copy normal nodes
+            std::for_each(groupsItEnd, m_Nodes.end(), copyNode);
+        }
     }
 # endif
 
@@ -1587,11 +1649,17 @@ bool ed::EditorContext::HasSelectionChanged()
 
 ed::Node* ed::EditorContext::FindNodeAt(const ImVec2& p)
 {
-    for (auto node : m_Nodes)
-        if (node->TestHit(p))
-            return node;
+    m_NodeGrid.Query(ImRect(p, p), m_QueryResult);
+
+    Node* result = nullptr;
+    for (auto object : m_QueryResult)
+    {
+        auto node = object->AsNode();
+        if (node->TestHit(p) && (!result || node->m_ZOrder < result->m_ZOrder))
+            result = node;
+    }
 
-    return nullptr;
+    return result;
 }
 
 void ed::EditorContext::FindNodesInRect(const ImRect& r, vector<Node*>& result, bool append, bool includeIntersecting)
@@ -1602,9 +1670,17 @@ void ed::EditorContext::FindNodesInRect(const ImRect& r, vector<Node*>& result,
     if (ImRect_IsEmpty(r))
         return;
 
-    for (auto node : m_Nodes)
+    m_NodeGrid.Query(r, m_QueryResult);
+
+    const auto first = result.size();
+    for (auto object : m_QueryResult)
+    {
+        auto node = object->AsNode();
         if (node->TestHit(r, includeIntersecting))
             result.push_back(node);
+    }
+
+    std::sort(result.begin() + first, result.end(), [](Node* lhs, Node* rhs) { return lhs->m_ZOrder < rhs->m_ZOrder; });
 }
 
 void ed::EditorContext::FindLinksInRect(const ImRect& r, vector<Link*>& result, bool append)
@@ -1615,9 +1691,17 @@ void ed::EditorContext::FindLinksInRect(const ImRect& r, vector<Link*>& result,
     if (ImRect_IsEmpty(r))
         return;
 
-    for (auto link : m_Links)
+    m_LinkGrid.Query(r, m_QueryResult);
+
+    const auto first = result.size();
+    for (auto object : m_QueryResult)
+    {
+        auto link = object->AsLink();
         if (link->TestHit(r))
             result.push_back(link);
+    }
+
+    std::sort(result.begin() + first, result.end(), [](Link* lhs, Link* rhs) { return lhs->m_ID.AsPointer() < rhs->m_ID.AsPointer(); });
 }
 
 void ed::EditorContext::FindLinksForNode(NodeId nodeId, vector<Link*>& result, bool add)
@@ -1680,8 +1764,8 @@ ed::Pin* ed::EditorContext::CreatePin(PinId id, PinKind kind)
 {
     IM_ASSERT(nullptr == FindObject(id));
     auto pin = new Pin(this, id, kind);
-    m_Pins.push_back({id, pin});
-    std::sort(m_Pins.begin(), m_Pins.end());
+    ObjectWrapper<Pin> item = {id, pin};
+    m_Pins.insert(std::upper_bound(m_Pins.begin(), m_Pins.end(), item), item);
     return pin;
 }
 
@@ -1690,6 +1774,7 @@ ed::Node* ed::EditorContext::CreateNode(NodeId id)
     IM_ASSERT(nullptr == FindObject(id));
     auto node = new Node(this, id);
     m_Nodes.push_back({id, node});
+    m_NodeIndex[id] = node;
     //std::sort(Nodes.begin(), Nodes.end());
 
     auto settings = m_Settings.FindNode(id);
@@ -1723,8 +1808,8 @@ ed::Link* ed::EditorContext::CreateLink(LinkId id)
 {
     IM_ASSERT(nullptr == FindObject(id));
     auto link = new Link(this, id);
-    m_Links.push_back({id, link});
-    std::sort(m_Links.begin(), m_Links.end());
+    ObjectWrapper<Link> item = {id, link};
+    m_Links.insert(std::upper_bound(m_Links.begin(), m_Links.end(), item), item);
 
     return link;
 }
@@ -1773,7 +1858,8 @@ static inline auto FindItemIn(C& container, Id id)
 
 ed::Node* ed::EditorContext::FindNode(NodeId id)
 {
-    return FindItemInLinear(m_Nodes, id);
+    auto it = m_NodeIndex.find(id);
+    return it != m_NodeIndex.end() ? it->second : nullptr;
 }
 
 ed::Pin* ed::EditorContext::FindPin(PinId id)
@@ -1877,11 +1963,104 @@ void ed::EditorContext::MakeDirty(SaveReasonFlags reason, Node* node)
 
 ed::Link* ed::EditorContext::FindLinkAt(const ImVec2& p)
 {
-    for (auto& link : m_Links)
-        if (link->TestHit(p, c_LinkSelectThickness))
-            return link;
+    auto area = ImRect(p, p);
+    area.Expand(c_LinkSelectThickness);
+    m_LinkGrid.Query(area, m_QueryResult);
+
+    Link* result = nullptr;
+    for (auto object : m_QueryResult)
+    {
+        auto link = object->AsLink();
+        if (link->TestHit(p, c_LinkSelectThickness) && (!result || link->m_ID.AsPointer() < result->m_ID.AsPointer()))
+            result = link;
+    }
+
+    return result;
+}
+
+ed::EditorContext::NodeIterator ed::EditorContext::FindNodeInZOrder(Node* node)
+{
+    // Position is known unless m_Nodes was reordered since it was recorded
+    if (node->m_ZOrder < static_cast<int>(m_Nodes.size()) && m_Nodes[node->m_ZOrder].m_Object == node)
+        return m_Nodes.begin() + node->m_ZOrder;
+
+    return std::find(m_Nodes.begin(), m_Nodes.end(), node);
+}
+
+void ed::EditorContext::UpdateZOrder(NodeIterator first)
+{
+    for (auto it = first; it != m_Nodes.end(); ++it)
+        (*it)->m_ZOrder = static_cast<int>(it - m_Nodes.begin());
+}
+
+bool ed::EditorContext::SortNodeChannelsInPlace(ImDrawList* drawList)
+{
+    // Each live node got c_ChannelsPerNode channels right after c_NodeStartChannel
+    // when it was submitted, so channels of all of them form one contiguous block.
+    // Only nodes whose slot in that block differs from their z-order are swapped.
+    const auto liveNodeCount = static_cast<int>(std::count_if(m_Nodes.begin(), m_Nodes.end(), [](Node* node) { return node->m_IsLive; }));
+    if (drawList->_Splitter._Count != c_NodeStartChannel + c_ChannelsPerNode * liveNodeCount)
+        return false;
+
+    m_ChannelOwners.assign(liveNodeCount, nullptr);
+    for (auto node : m_Nodes)
+    {
+        if (!node->m_IsLive)
+            continue;
+
+        const auto offset = node->m_Channel - c_NodeStartChannel;
+        if (offset < 0 || offset % c_ChannelsPerNode != 0 || m_ChannelOwners[offset / c_ChannelsPerNode])
+            return false;
+
+        m_ChannelOwners[offset / c_ChannelsPerNode] = node;
+    }
+
+    int slot = 0;
+    for (auto node : m_Nodes)
+    {
+        if (!node->m_IsLive)
+            continue;
+
+        const auto targetChannel = c_NodeStartChannel + slot * c_ChannelsPerNode;
+        if (node->m_Channel != targetChannel)
+        {
+            auto displacedNode = m_ChannelOwners[slot];
+
+            for (int i = 0; i < c_ChannelsPerNode; ++i)
+                ImDrawList_SwapChannels(drawList, node->m_Channel + i, targetChannel + i);
+
+            m_ChannelOwners[(node->m_Channel - c_NodeStartChannel) / c_ChannelsPerNode] = displacedNode;
+            displacedNode->m_Channel = node->m_Channel;
+
+            m_ChannelOwners[slot] = node;
+            node->m_Channel = targetChannel;
+        }
+
+        ++slot;
+    }
+
+    return true;
+}
+
+void ed::EditorContext::UpdateSpatialIndex()
+{
+    int zOrder = 0;
+    for (auto node : m_Nodes)
+    {
+        node->m_ZOrder = zOrder++;
+        if (node->m_IsLive)
+            m_NodeGrid.Update(node, node->GetBounds());
+        else
+            m_NodeGrid.Remove(node);
+    }
 
-    return nullptr;
+    for (auto link : m_Links)
+    {
+        if (link->m_IsLive)
+            m_LinkGrid.Update(link, link->GetBounds());
+        else
+            m_LinkGrid.Remove(link);
+    }
 }
 
 ImU32 ed::EditorContext::GetColor(StyleColor colorIndex) const
@@ -2197,6 +2376,136 @@ void ed::EditorContext::ShowMetrics(const Control& control)
 
 
 
+//------------------------------------------------------------------------------
+//
+// Spatial Grid
+//
+//------------------------------------------------------------------------------
+void ed::SpatialGrid::Update(Object* object, const ImRect& bounds)
+{
+    const auto range = GetCellRange(bounds);
+
+    auto it = m_Ranges.find(object);
+    if (it != m_Ranges.end())
+    {
+        if (it->second == range)
+            return;
+
+        Erase(object, it->second);
+        it->second = range;
+    }
+    else
+        m_Ranges.emplace(object, range);
+
+    Insert(object, range);
+}
+
+void ed::SpatialGrid::Remove(Object* object)
+{
+    auto it = m_Ranges.find(object);
+    if (it == m_Ranges.end())
+        return;
+
+    Erase(object, it->second);
+    m_Ranges.erase(it);
+}
+
+void ed::SpatialGrid::Query(const ImRect& rect, vector<Object*>& result) const
+{
+    result.assign(m_Oversized.begin(), m_Oversized.end());
+
+    const auto range = GetCellRange(rect);
+
+    // Visiting the cells would cost more than testing everything
+    if (range.GetCellCount() >= static_cast<int64_t>(m_Ranges.size()))
+    {
+        result.clear();
+        for (auto& entry : m_Ranges)
+            result.push_back(entry.first);
+        return;
+    }
+
+    const auto first = result.size();
+    for (int y = range.MinY; y <= range.MaxY; ++y)
+    {
+        for (int x = range.MinX; x <= range.MaxX; ++x)
+        {
+            auto cell = m_Cells.find(GetCellKey(x, y));
+            if (cell != m_Cells.end())
+                result.insert(result.end(), cell->second.begin(), cell->second.end());
+        }
+    }
+
+    // Objects spanning several cells were added once per cell
+    if (range.MinX != range.MaxX || range.MinY != range.MaxY)
+    {
+        std::sort(result.begin() + first, result.end());
+        result.erase(std::unique(result.begin() + first, result.end()), result.end());
+    }
+}
+
+ed::SpatialGrid::CellRange ed::SpatialGrid::GetCellRange(const ImRect& bounds) const
+{
+    const auto invCellSize = 1.0f / m_CellSize;
+
+    CellRange range;
+    range.MinX = static_cast<int>(ImFloor(bounds.Min.x * invCellSize));
+    range.MinY = static_cast<int>(ImFloor(bounds.Min.y * invCellSize));
+    range.MaxX = static_cast<int>(ImFloor(bounds.Max.x * invCellSize));
+    range.MaxY = static_cast<int>(ImFloor(bounds.Max.y * invCellSize));
+    return range;
+}
+
+void ed::SpatialGrid::Insert(Object* object, const CellRange& range)
+{
+    if (range.GetCellCount() > c_MaxCellsPerObject)
+    {
+        m_Oversized.push_back(object);
+        return;
+    }
+
+    for (int y = range.MinY; y <= range.MaxY; ++y)
+        for (int x = range.MinX; x <= range.MaxX; ++x)
+            m_Cells[GetCellKey(x, y)].push_back(object);
+}
+
+void ed::SpatialGrid::Erase(Object* object, const CellRange& range)
+{
+    auto eraseFrom = [object](vector<Object*>& objects)
+    {
+        auto it = std::find(objects.begin(), objects.end(), object);
+        if (it == objects.end())
+            return;
+
+        *it = objects.back();
+        objects.pop_back();
+    };
+
+    if (range.GetCellCount() > c_MaxCellsPerObject)
+    {
+        eraseFrom(m_Oversized);
+        return;
+    }
+
+    for (int y = range.MinY; y <= range.MaxY; ++y)
+    {
+        for (int x = range.MinX; x <= range.MaxX; ++x)
+        {
+            auto cell = m_Cells.find(GetCellKey(x, y));
+            if (cell == m_Cells.end())
+                continue;
+
+            eraseFrom(cell->second);
+            if (cell->second.empty())
+                m_Cells.erase(cell);
+        }
+    }
+}
+
+
+
+
+
 //------------------------------------------------------------------------------
 //
 // Node Settings
@@ -2281,17 +2590,15 @@ bool ed::NodeSettings::Parse(const json::value& data, NodeSettings& result)
 //------------------------------------------------------------------------------
 ed::NodeSettings* ed::Settings::AddNode(NodeId id)
 {
+    m_NodeIndex[id] = m_Nodes.size();
     m_Nodes.push_back(NodeSettings(id));
     return &m_Nodes.back();
 }
 
 ed::NodeSettings* ed::Settings::FindNode(NodeId id)
 {
-    for (auto& settings : m_Nodes)
-        if (settings.m_ID == id)
-            return &settings;
-
-    return nullptr;
+    auto it = m_NodeIndex.find(id);
+    return it != m_NodeIndex.end() ? &m_Nodes[it->second] : nullptr;
 }
 
 void ed::Settings::ClearDirty(Node* node)
@@ -28,6 +28,7 @@
 
 # include <vector>
 # include <string>
+# include <unordered_map>
 
 
 //------------------------------------------------------------------------------
@@ -44,6 +45,7 @@ namespace json = crude_json;
 //------------------------------------------------------------------------------
 using std::vector;
 using std::string;
+using std::unordered_map;
 
 
 //------------------------------------------------------------------------------
@@ -178,6 +180,12 @@ struct Node;
 struct Pin;
 struct Link;
 
+template <typename Id>
+struct IdHash
+{
+    size_t operator()(const Id& id) const { return std::hash<uintptr_t>()(id.Get()); }
+};
+
 template <typename T, typename Id = typename T::IdType>
 struct ObjectWrapper
 {
@@ -373,6 +381,7 @@ struct Node final: Object
     NodeType m_Type;
     ImRect   m_Bounds;
     int      m_Channel;
+    int      m_ZOrder; // position in m_Nodes
     Pin*     m_LastPin;
     ImVec2   m_DragStart;
 
@@ -396,6 +405,7 @@ struct Node final: Object
         , m_Type(NodeType::Node)
         , m_Bounds()
         , m_Channel(0)
+        , m_ZOrder(0)
         , m_LastPin(nullptr)
         , m_DragStart()
         , m_Color(IM_COL32_WHITE)
@@ -451,6 +461,10 @@ struct Link final: Object
         , m_EndPin(nullptr)
         , m_Color(IM_COL32_WHITE)
         , m_Thickness(1.0f)
+        , m_Geometry()
+        , m_Curve()
+        , m_CurveBounds()
+        , m_PolylineTolerance(0.0f)
     {
     }
 
@@ -461,9 +475,10 @@ struct Link final: Object
     virtual void Draw(ImDrawList* drawList, DrawFlags flags = None) override final;
     void Draw(ImDrawList* drawList, ImU32 color, float extraThickness = 0.0f) const;
 
+    // Also rebuilds the cached curve and bounds, if anything they depend on changed
     void UpdateEndpoints();
 
-    ImCubicBezierPoints GetCurve() const;
+    const ImCubicBezierPoints& GetCurve() const { return m_Curve; }
 
     virtual bool TestHit(const ImVec2& point, float extraThickness = 0.0f) const override final;
     virtual bool TestHit(const ImRect& rect, bool allowIntersect = true) const override final;
@@ -471,6 +486,30 @@ struct Link final: Object
     virtual ImRect GetBounds() const override final;
 
     virtual Link* AsLink() override final { return this; }
+
+private:
+    // Everything the curve and its bounds are computed from
+    struct Geometry
+    {
+        ImVec2 Start;
+        ImVec2 End;
+        ImVec2 StartDir;
+        ImVec2 EndDir;
+        float  StartStrength;
+        float  EndStrength;
+        float  StartArrowSize;
+        float  EndArrowSize;
+    };
+
+    ImCubicBezierPoints BuildCurve() const;
+    ImRect BuildBounds() const;
+    const ImVector<ImVec2>& GetPolyline(ImDrawList* drawList) const;
+
+    Geometry                 m_Geometry;
+    ImCubicBezierPoints      m_Curve;
+    ImRect                   m_CurveBounds;
+    mutable ImVector<ImVec2> m_Polyline; // tessellated on first draw, empty while out of date
+    mutable float            m_PolylineTolerance;
 };
 
 struct NodeSettings
@@ -512,6 +551,7 @@ struct Settings
     SaveReasonFlags      m_DirtyReason;
 
     vector<NodeSettings> m_Nodes;
+    unordered_map<NodeId, size_t, IdHash<NodeId>> m_NodeIndex; // position in m_Nodes
     vector<ObjectId>     m_Selection;
     ImVec2               m_ViewScroll;
     float                m_ViewZoom;
@@ -1229,6 +1269,47 @@ struct Config: ax::NodeEditor::Config
     void EndSave();
 };
 
+// Uniform grid over object bounds, used to narrow down hit tests and rect queries.
+// Objects are only moved between cells when their bounds cross a cell boundary.
+struct SpatialGrid
+{
+    SpatialGrid(float cellSize = 256.0f)
+        : m_CellSize(cellSize)
+    {
+    }
+
+    void Update(Object* object, const ImRect& bounds);
+    void Remove(Object* object);
+
+    // Every object whose bounds may overlap the rect, each one once and in no particular order
+    void Query(const ImRect& rect, vector<Object*>& result) const;
+
+private:
+    struct CellRange
+    {
+        int MinX, MinY, MaxX, MaxY;
+
+        bool operator==(const CellRange& rhs) const { return MinX == rhs.MinX && MinY == rhs.MinY && MaxX == rhs.MaxX && MaxY == rhs.MaxY; }
+        bool operator!=(const CellRange& rhs) const { return !(*this == rhs); }
+
+        int64_t GetCellCount() const { return int64_t(MaxX - MinX + 1) * (MaxY - MinY + 1); }
+    };
+
+    // Objects spanning more cells than that are kept aside and returned by every query
+    static const int c_MaxCellsPerObject = 64;
+
+    CellRange GetCellRange(const ImRect& bounds) const;
+    static uint64_t GetCellKey(int x, int y) { return (uint64_t(uint32_t(x)) << 32) | uint32_t(y); }
+
+    void Insert(Object* object, const CellRange& range);
+    void Erase(Object* object, const CellRange& range);
+
+    float                                   m_CellSize;
+    unordered_map<uint64_t, vector<Object*>> m_Cells;
+    unordered_map<Object*, CellRange>       m_Ranges;
+    vector<Object*>                         m_Oversized;
+};
+
 struct EditorContext
 {
     EditorContext(const ax::NodeEditor::Config* config = nullptr);
@@ -1377,6 +1458,17 @@ private:
     void LoadSettings();
     void SaveSettings();
 
+    // Brings the spatial grids in line with this frame's bounds, must run before any hit test
+    void UpdateSpatialIndex();
+
+    using NodeIterator = vector<ObjectWrapper<Node>>::iterator;
+    NodeIterator FindNodeInZOrder(Node* node);
+    // Refreshes m_ZOrder of nodes from first on, after they were moved around in m_Nodes
+    void UpdateZOrder(NodeIterator first);
+    // Puts channels of live nodes in z-order without growing the channel list,
+    // false if that's not possible and everything has to be copied
+    bool SortNodeChannelsInPlace(ImDrawList* drawList);
+
     Control BuildControl(bool allowOffscreen);
 
     void ShowMetrics(const Control& control);
@@ -1394,6 +1486,14 @@ private:
     vector<ObjectWrapper<Pin>>  m_Pins;
     vector<ObjectWrapper<Link>> m_Links;
 
+    // m_Nodes is kept in z-order, nodes are looked up by id here instead
+    unordered_map<NodeId, Node*, IdHash<NodeId>> m_NodeIndex;
+
+    SpatialGrid         m_NodeGrid;
+    SpatialGrid         m_LinkGrid;
+    vector<Object*>     m_QueryResult;
+    vector<Node*>       m_ChannelOwners;
+
     vector<Object*>     m_SelectedObjects;
 
     vector<Object*>     m_LastSelectedObjects;
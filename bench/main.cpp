@@ -0,0 +1,343 @@
+#include <uuid.h>
+#include <StateMachine.h>
+#include <Random.h>
+#include <Scene.h>
+#include <SceneSerializer.h>
+
+#include <imgui.h>
+#include <imgui_canvas.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum ExitCode : int {
+	EXIT_OK = 0,
+	EXIT_FAILED = 1,//A benchmark's check failed
+	EXIT_USAGE = 2
+};
+
+struct Benchmark {
+	const char* Name;
+	const char* Description;
+	bool(*Run)(void);
+};
+
+static void PrintUsage(void);
+static bool BenchmarkUUID(void);
+static bool BenchmarkEditor(void);
+static bool BenchmarkCanvas(void);
+
+static constexpr Benchmark BENCHMARKS[] = {
+	{ "uuid", "uuid lookups and Fork visits, hashing the string form against the raw bytes and fork slots", BenchmarkUUID },
+	{ "editor", "Loading, saving and rendering frames of a Character with 1k, 10k and 50k nodes in the node editor", BenchmarkEditor },
+	{ "canvas", "Moving 1M random vertices to screen space, checking the SIMD path against the scalar one", BenchmarkCanvas },
+};
+
+// Results are written here so the optimizer can't drop the work being timed
+static volatile uint64_t sSink = 0;
+
+/**
+* @brief Runs fn a few times and keeps its fastest run
+* @returns Seconds of the fastest run
+*/
+template<typename Fn>
+static double Best(Fn&& fn)
+{
+	static constexpr int RUNS = 5;
+	double best = std::numeric_limits<double>::max();
+	for (int run = 0; run < RUNS; run++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		fn();
+		best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<const Benchmark*> selected;
+	for (int i = 1; i < argc; i++)
+	{
+		const auto it = std::find_if(std::begin(BENCHMARKS), std::end(BENCHMARKS), [name = std::string(argv[i])](const Benchmark& benchmark) { return name == benchmark.Name; });
+		if (it == std::end(BENCHMARKS))
+		{
+			std::fprintf(stderr, "Unknown benchmark: %s\n", argv[i]);
+			PrintUsage();
+			return EXIT_USAGE;
+		}
+		selected.push_back(&*it);
+	}
+	if (selected.empty())
+		for (const auto& benchmark : BENCHMARKS)
+			selected.push_back(&benchmark);
+
+	int failed = 0;
+	for (const auto* benchmark : selected)
+	{
+		std::printf("%s:\n", benchmark->Name);
+		failed += benchmark->Run() ? 0 : 1;
+	}
+	return failed > 0 ? EXIT_FAILED : EXIT_OK;
+}
+
+void PrintUsage(void)
+{
+	std::fprintf(stderr, "Usage: purupuru-bench [benchmarks...]\n\nRuns every benchmark if none is given:\n");
+	for (const auto& benchmark : BENCHMARKS)
+		std::fprintf(stderr, "  %-12s%s\n", benchmark.Name, benchmark.Description);
+}
+
+/**
+* @brief Hashes the string form of a uuid, like std::hash<gte::uuid> did before it hashed the raw bytes
+*/
+struct StringHash {
+	size_t operator()(const gte::uuid& id) const { return std::hash<std::string>{}(id.str()); }
+};
+
+bool BenchmarkUUID(void)
+{
+	static constexpr uint32_t KEYS = 2000;
+	static constexpr size_t LOOKUPS = 1'000'000;
+
+	std::vector<gte::uuid> ids;
+	ids.reserve(KEYS);
+	for (uint32_t i = 0; i < KEYS; i++)
+		ids.emplace_back(gte::uuid::Create());
+
+	// Drawn up front so every side looks up the same keys in the same order
+	Random random(1);
+	std::vector<uint32_t> order(LOOKUPS);
+	for (auto& index : order)
+		index = random.Below(KEYS);
+
+	std::unordered_map<gte::uuid, bool, StringHash> byString;
+	std::unordered_map<gte::uuid, bool> byBytes;
+	for (uint32_t i = 0; i < KEYS; i++)
+	{
+		byString.emplace(ids[i], i % 2 == 0);
+		byBytes.emplace(ids[i], i % 2 == 0);
+	}
+	auto lookUp = [&ids, &order](const auto& map) {
+		uint64_t found = 0;
+		for (const auto index : order)
+			found += map.find(ids[index])->second ? 1 : 0;
+		sSink = found;
+	};
+	const double stringLookups = Best([&]() { lookUp(byString); });
+	const double byteLookups = Best([&]() { lookUp(byBytes); });
+
+	// Fork visits went through a boolean keyed by the formatted uuid, they're a bit of a slot now
+	std::unordered_map<std::string, bool> visitedByString;
+	StateMachine state;
+	std::vector<StateMachine::Slot> slots;
+	slots.reserve(KEYS);
+	for (const auto& id : ids)
+		slots.push_back(state.InternFork(id));
+
+	const double stringVisits = Best([&]() {
+		uint64_t visited = 0;
+		for (const auto index : order)
+		{
+			bool& value = visitedByString[ids[index].str()];
+			visited += value ? 1 : 0;
+			value = true;
+		}
+		sSink = visited;
+	});
+	const double slotVisits = Best([&]() {
+		uint64_t visited = 0;
+		for (const auto index : order)
+		{
+			visited += state.IsVisited(slots[index]) ? 1 : 0;
+			state.SetVisited(slots[index], true);
+		}
+		sSink = visited;
+	});
+
+	auto nanoseconds = [](double seconds) { return seconds * 1e9 / static_cast<double>(LOOKUPS); };
+	std::printf("  lookup among %u uuids: %.1f ns hashing the string, %.1f ns hashing the bytes\n", KEYS, nanoseconds(stringLookups), nanoseconds(byteLookups));
+	std::printf("  Fork visit: %.1f ns keyed by the string, %.1f ns through a fork slot\n", nanoseconds(stringVisits), nanoseconds(slotVisits));
+	return true;
+}
+
+/**
+* @brief Writes a project with one Character made of an Entry and a chain of Acts laid out on a grid
+*/
+static bool WriteChain(const std::string& filepath, size_t nodes)
+{
+	static constexpr size_t COLUMNS = 100;
+	int32_t nextID = 1;
+	std::string yaml = "- Name: Chain\n  EntryNode:\n";
+	const int32_t entryOutput = nextID + 1;
+	yaml += "  - ID: " + std::to_string(nextID) + "\n    Position: [0, 0]\n    Output: " + std::to_string(entryOutput) + "\n";
+	nextID += 2;
+
+	std::string links;
+	int32_t previousOutput = entryOutput;
+	yaml += "  ActNodes:\n";
+	for (size_t i = 1; i < nodes; i++)
+	{
+		const int32_t id = nextID++, input = nextID++, output = nextID++;
+		yaml += "  - ID: " + std::to_string(id);
+		yaml += "\n    Position: [" + std::to_string(i % COLUMNS * 300) + ", " + std::to_string(i / COLUMNS * 200) + "]";
+		yaml += "\n    Title: Act " + std::to_string(i);
+		yaml += "\n    Input: " + std::to_string(input) + "\n    Output: " + std::to_string(output);
+		yaml += "\n    Bubbles:\n    - Speaker: NPC\n      Line: Line " + std::to_string(i) + "\n";
+		links += "  - ID: " + std::to_string(nextID++) + "\n    StartPinID: " + std::to_string(previousOutput) + "\n    EndPinID: " + std::to_string(input) + "\n";
+		previousOutput = output;
+	}
+	yaml += "  Links:\n" + links;
+
+	std::ofstream ofs(filepath, std::ios::binary);
+	ofs << yaml;
+	return static_cast<bool>(ofs);
+}
+
+bool BenchmarkEditor(void)
+{
+	static constexpr size_t SIZES[] = { 1'000, 10'000, 50'000 };
+	static constexpr int FRAMES = 10;
+
+	// The node editor reads and writes NodeEditor.json in the working directory, keep it out of the user's
+	std::error_code error;
+	const auto directory = std::filesystem::temp_directory_path() / "purupuru-bench-editor";
+	std::filesystem::create_directories(directory, error);
+	const auto workingDirectory = std::filesystem::current_path();
+	std::filesystem::current_path(directory, error);
+	if (error)
+	{
+		std::printf("  couldn't use %s\n", directory.string().c_str());
+		return false;
+	}
+
+	// No window or renderer: frames are built by ImGui and then dropped, so they measure the CPU side only
+	ImGui::CreateContext();
+	auto& io = ImGui::GetIO();
+	io.IniFilename = nullptr;
+	io.DisplaySize = ImVec2{ 1920.0f, 1080.0f };
+	io.DeltaTime = 1.0f / 60.0f;
+	unsigned char* pixels = nullptr;
+	int width = 0, height = 0;
+	io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+	ImGui::LoadIniSettingsFromMemory("[Window][Node Editor]\nPos=0,20\nSize=1920,1060\n");
+
+	bool succeeded = true;
+	for (const size_t nodes : SIZES)
+	{
+		const std::string input = "chain-" + std::to_string(nodes) + ".puru";
+		const std::string output = "chain-" + std::to_string(nodes) + ".saved.puru";
+		if (!WriteChain(input, nodes))
+		{
+			std::printf("  couldn't write %s\n", input.c_str());
+			succeeded = false;
+			break;
+		}
+
+		double load = 0.0, save = 0.0, firstFrame = 0.0, frame = 0.0;
+		{
+			Scene scene;
+			auto start = std::chrono::steady_clock::now();
+			if (!SceneSerializer{ &scene }.Deserialize(input))
+			{
+				std::printf("  couldn't load %s\n", input.c_str());
+				succeeded = false;
+				break;
+			}
+			load = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			if (!SceneSerializer{ &scene }.Serialize(output))
+			{
+				std::printf("  couldn't save %s\n", output.c_str());
+				succeeded = false;
+				break;
+			}
+			save = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			// The first frame creates every pin and link of the node editor and the stack layouts ImGui keeps for
+			// every node, it's timed on its own. Layouts are inserted in a sorted ImGuiStorage, eight per node,
+			// which makes this frame grow faster than the node count
+			for (int i = 0; i <= FRAMES; i++)
+			{
+				start = std::chrono::steady_clock::now();
+				ImGui::NewFrame();
+				scene.RenderFrame();
+				ImGui::Render();
+				const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				if (i == 0)
+					firstFrame = seconds;
+				else
+					frame += seconds;
+			}
+			frame /= FRAMES;
+		}
+		std::printf("  %zu nodes: load %.1f ms, save %.1f ms, first frame %.1f ms, then %.2f ms per frame\n", nodes, load * 1000.0, save * 1000.0, firstFrame * 1000.0, frame * 1000.0);
+
+		std::filesystem::remove(input, error);
+		std::filesystem::remove(output, error);
+	}
+	std::printf("  frames are built without a window or renderer, the GPU's share of a frame isn't included\n");
+
+	ImGui::DestroyContext();
+	std::filesystem::current_path(workingDirectory, error);
+	std::filesystem::remove_all(directory, error);
+	return succeeded;
+}
+
+bool BenchmarkCanvas(void)
+{
+	static constexpr size_t VERTICES = 1'000'000;
+	static constexpr float SCALES[] = { 1.0f, 0.37f, 2.5f };
+	static const ImVec2 OFFSET{ 123.25f, -456.5f };
+
+	Random random(1);
+	std::vector<ImDrawVert> source(VERTICES);
+	for (auto& vertex : source)
+	{
+		vertex.pos = ImVec2{ random.Float() * 20000.0f - 10000.0f, random.Float() * 20000.0f - 10000.0f };
+		vertex.uv = ImVec2{ random.Float(), random.Float() };
+		vertex.col = random.Below(std::numeric_limits<uint32_t>::max());
+	}
+	// Values where a sloppy SIMD path would round or flush differently
+	source[0].pos = ImVec2{ -0.0f, std::numeric_limits<float>::denorm_min() };
+	source[1].pos = ImVec2{ std::numeric_limits<float>::max() / 4.0f, std::numeric_limits<float>::lowest() / 4.0f };
+	source[2].pos = ImVec2{ std::nextafter(1.0f, 2.0f), -std::numeric_limits<float>::epsilon() };
+
+	bool identical = true;
+	for (const float scale : SCALES)
+	{
+		std::vector<ImDrawVert> scalar = source, simd = source;
+		ImGuiEx::TransformVerticesScalar(scalar.data(), scalar.data() + scalar.size(), scale, OFFSET);
+		ImGuiEx::TransformVertices(simd.data(), simd.data() + simd.size(), scale, OFFSET);
+		const bool same = std::memcmp(scalar.data(), simd.data(), VERTICES * sizeof(ImDrawVert)) == 0;
+		identical &= same;
+		if (!same)
+		{
+			const auto mismatch = std::mismatch(scalar.begin(), scalar.end(), simd.begin(), [](const ImDrawVert& lhs, const ImDrawVert& rhs) { return std::memcmp(&lhs, &rhs, sizeof(ImDrawVert)) == 0; });
+			const auto index = static_cast<size_t>(mismatch.first - scalar.begin());
+			std::printf("  scale %.2f: vertex %zu differs, scalar (%.9g, %.9g), SIMD (%.9g, %.9g)\n", scale, index, mismatch.first->pos.x, mismatch.first->pos.y, mismatch.second->pos.x, mismatch.second->pos.y);
+		}
+
+		// Each run transforms the previous run's output again, it's the same work on the same number of vertices
+		const double scalarTime = Best([&]() {
+			ImGuiEx::TransformVerticesScalar(scalar.data(), scalar.data() + scalar.size(), scale, OFFSET);
+			sSink = static_cast<uint64_t>(scalar.back().pos.x);
+		});
+		const double simdTime = Best([&]() {
+			ImGuiEx::TransformVertices(simd.data(), simd.data() + simd.size(), scale, OFFSET);
+			sSink = static_cast<uint64_t>(simd.back().pos.x);
+		});
+		std::printf("  scale %.2f: %s, %.3f ms per million vertices scalar, %.3f ms SIMD\n", scale, same ? "identical" : "MISMATCH", scalarTime * 1e9 / VERTICES, simdTime * 1e9 / VERTICES);
+	}
+	return identical;
+}
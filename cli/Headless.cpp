@@ -0,0 +1,10 @@
+#include <Application.h>
+#include <FileDialog.h>
+
+// The editor's rendering code is linked in but never runs in the CLI, these only satisfy the linker
+
+ImTextureID Application_LoadTexture(const char*) { return nullptr; }
+int Application_GetTextureWidth(ImTextureID) { return 0; }
+int Application_GetTextureHeight(ImTextureID) { return 0; }
+
+std::string CreateFileDialog(FileDialogType, const char*) { return {}; }
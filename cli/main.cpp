@@ -0,0 +1,543 @@
+#include <Scene.h>
+#include <SceneSerializer.h>
+#include <ExportSerializer.h>
+#include <BinaryExportSerializer.h>
+#include <Analyzer.h>
+#include <DialogueProgram.h>
+#include <MappedFile.h>
+#include <Simulator.h>
+#include <ThreadPool.h>
+
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum ExitCode : int {
+	EXIT_OK = 0,
+	EXIT_FAILED = 1,//At least one file failed
+	EXIT_USAGE = 2
+};
+
+struct Options {
+	std::string Command;
+	std::vector<std::string> Inputs;
+	std::string OutputDirectory;
+	size_t Jobs = 0;
+	bool Binary = false;
+	uint64_t Runs = Simulator::Settings{}.Runs;
+	uint64_t Seed = 0;
+	size_t Memory = Analyzer::Settings{}.MemoryLimit;
+};
+
+struct Result {
+	bool Succeeded = true;
+	std::string Message;
+};
+
+static void PrintUsage(void);
+static bool ParseOptions(int argc, char** argv, Options& options);
+static std::string OutputPath(const Options& options, const std::string& input, const char* extension);
+static size_t ThreadsPerFile(const Options& options);
+static bool Load(const Options& options, Scene& scene, const std::string& filepath, Result& result);
+
+static Result Export(const Options& options, const std::string& input);
+static Result ExportLines(const Options& options, const std::string& input);
+static Result Validate(const Options& options, const std::string& input);
+static Result Stats(const Options& options, const std::string& input);
+static Result Benchmark(const Options& options, const std::string& input);
+static Result Simulate(const Options& options, const std::string& input);
+static Result Analyze(const Options& options, const std::string& input);
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_USAGE;
+	}
+
+	Result(*command)(const Options&, const std::string&) = nullptr;
+	if (options.Command == "export")				command = Export;
+	else if (options.Command == "export-lines")		command = ExportLines;
+	else if (options.Command == "validate")			command = Validate;
+	else if (options.Command == "stats")			command = Stats;
+	else if (options.Command == "benchmark")		command = Benchmark;
+	else if (options.Command == "simulate")			command = Simulate;
+	else if (options.Command == "analyze")			command = Analyze;
+	else
+	{
+		std::fprintf(stderr, "Unknown command: %s\n", options.Command.c_str());
+		PrintUsage();
+		return EXIT_USAGE;
+	}
+
+	if (!options.OutputDirectory.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(options.OutputDirectory, error);
+	}
+
+	// Every file is loaded into its own headless Scene on one worker, results are printed in input order.
+	// Benchmarks, simulations and analyses use every thread on a single file, so they run one file at a time
+	const bool oneAtATime = options.Command == "benchmark" || options.Command == "simulate" || options.Command == "analyze";
+	const size_t jobs = oneAtATime ? 1 : options.Jobs == 0 ? std::thread::hardware_concurrency() : options.Jobs;
+	ThreadPool pool(std::min(jobs, options.Inputs.size()));
+	std::vector<std::future<Result>> results;
+	results.reserve(options.Inputs.size());
+	for (const auto& input : options.Inputs)
+		results.emplace_back(pool.Submit([&options, &input, command]() { return command(options, input); }));
+
+	int failed = 0;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		// A command that throws past Load only fails its own file, the others still get reported
+		Result result;
+		try { result = results[i].get(); }
+		catch (const std::exception& e) { result = { false, e.what() }; }
+		if (!result.Message.empty())
+			std::fprintf(result.Succeeded ? stdout : stderr, "%s: %s\n", options.Inputs[i].c_str(), result.Message.c_str());
+		failed += result.Succeeded ? 0 : 1;
+	}
+
+	if (failed > 0)
+		std::fprintf(stderr, "%d of %zu file(s) failed\n", failed, options.Inputs.size());
+	return failed > 0 ? EXIT_FAILED : EXIT_OK;
+}
+
+void PrintUsage(void)
+{
+	std::fprintf(stderr,
+		"Usage: purupuru-cli <command> [options] <files...>\n"
+		"\n"
+		"Commands:\n"
+		"  export          Exports every .puru project to .epuru (or .bpuru with --binary)\n"
+		"  export-lines    Writes the Act lines of every .puru project to a .txt file\n"
+		"  validate        Checks .puru projects and .bpuru binary exports\n"
+		"  stats           Prints node, line and word counts of .puru projects\n"
+		"  benchmark       Times the export of .puru projects with 1 to --jobs threads\n"
+		"  simulate        Plays random playthroughs of every Character and reports which nodes they reach\n"
+		"  analyze         Explores every playthrough of every Character, fails on dead nodes, loops, divisions by zero\n"
+		"                  and on Characters it couldn't explore fully within --memory\n"
+		"\n"
+		"Options:\n"
+		"  -o, --output <dir>  Directory for the written files, next to each input by default\n"
+		"  -j, --jobs <n>      Files processed at once, or threads of a single export or simulation, one per hardware thread by default\n"
+		"  --binary            Makes export write the binary format\n"
+		"  --runs <n>          Playthroughs per Character for simulate, 1000000 by default\n"
+		"  --seed <n>          Makes simulate repeatable, random by default\n"
+		"  --memory <MiB>      States analyze may keep per Character, 512 by default\n"
+		"\n"
+		"Exit code is 0 on success, 1 if any file failed and 2 on invalid usage.\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options& options)
+{
+	if (argc < 2)
+		return false;
+
+	options.Command = argv[1];
+	for (int i = 2; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+			options.OutputDirectory = argv[++i];
+		else if ((arg == "-j" || arg == "--jobs") && i + 1 < argc)
+		{
+			const int jobs = std::atoi(argv[++i]);
+			if (jobs <= 0)
+				return false;
+			options.Jobs = static_cast<size_t>(jobs);
+		}
+		else if (arg == "--binary")
+			options.Binary = true;
+		else if (arg == "--runs" && i + 1 < argc)
+		{
+			options.Runs = std::strtoull(argv[++i], nullptr, 10);
+			if (options.Runs == 0)
+				return false;
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+			options.Seed = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--memory" && i + 1 < argc)
+		{
+			options.Memory = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10)) * 1024 * 1024;
+			if (options.Memory == 0)
+				return false;
+		}
+		else if (arg.size() > 1 && arg[0] == '-')
+			return false;
+		else
+			options.Inputs.emplace_back(arg);
+	}
+	return !options.Inputs.empty();
+}
+
+std::string OutputPath(const Options& options, const std::string& input, const char* extension)
+{
+	std::filesystem::path path = input;
+	path.replace_extension(extension);
+	if (!options.OutputDirectory.empty())
+		path = std::filesystem::path(options.OutputDirectory) / path.filename();
+	return path.string();
+}
+
+size_t ThreadsPerFile(const Options& options)
+{
+	// Several files are already processed side by side, a single one uses every thread for its Characters
+	return options.Inputs.size() > 1 ? 1 : options.Jobs;
+}
+
+bool Load(const Options& options, Scene& scene, const std::string& filepath, Result& result)
+{
+	try
+	{
+		if (SceneSerializer{ &scene }.Deserialize(filepath, ThreadsPerFile(options)))
+			return true;
+		result.Message = "couldn't be read or parsed";
+	}
+	catch (const YAML::Exception& e) { result.Message = e.what(); }
+	catch (const std::exception& e) { result.Message = e.what(); }
+	result.Succeeded = false;
+	return false;
+}
+
+Result Export(const Options& options, const std::string& input)
+{
+	Result result;
+	Scene scene(true);
+	if (!Load(options, scene, input, result))
+		return result;
+
+	const std::string output = OutputPath(options, input, options.Binary ? ".bpuru" : ".epuru");
+	const bool written = options.Binary ? BinaryExportSerializer{ &scene }.Serialize(output) : ExportSerializer{ &scene, ThreadsPerFile(options) }.Serialize(output);
+	if (!written)
+		return { false, "couldn't write " + output };
+	return { true, "exported to " + output };
+}
+
+Result ExportLines(const Options& options, const std::string& input)
+{
+	Result result;
+	Scene scene(true);
+	if (!Load(options, scene, input, result))
+		return result;
+
+	const std::string output = OutputPath(options, input, ".txt");
+	if (!ExportSerializer{ &scene }.SerializeLines(output))
+		return { false, "couldn't write " + output };
+	return { true, "exported lines to " + output };
+}
+
+Result Validate(const Options& options, const std::string& input)
+{
+	if (std::filesystem::path(input).extension() == ".bpuru")
+	{
+		MappedFile file(input);
+		if (!file.IsOpen())
+			return { false, "couldn't be read" };
+		if (const char* error = BinaryExport(file.Data(), file.Size()).Validate())
+			return { false, error };
+		return {};
+	}
+
+	Result result;
+	Scene scene(true);
+	if (!Load(options, scene, input, result))
+		return result;
+
+	if (scene.GetCharacterCount() == 0)
+		return { false, "has no characters" };
+
+	for (size_t i = 0; i < scene.GetCharacterCount(); i++)
+	{
+		StateMachine state;
+		const DialogueProgram program{ scene.GetCharacter(i), state };
+		if (program.GetEntry() == DialogueProgram::END)
+			return { false, std::string(scene.GetCharacterName(i)) + " has no entry node" };
+	}
+	return {};
+}
+
+Result Stats(const Options& options, const std::string& input)
+{
+	Result result;
+	Scene scene(true);
+	if (!Load(options, scene, input, result))
+		return result;
+
+	static constexpr std::array<NodeType, 13> TYPES = {
+		NodeType::Entry, NodeType::BoolVariable, NodeType::IntVariable, NodeType::Act, NodeType::Fork,
+		NodeType::Branch, NodeType::Dialogue, NodeType::FlavorMatch, NodeType::FlavorCheck, NodeType::Dice,
+		NodeType::AcceptQuest, NodeType::ReturnQuest, NodeType::Objective
+	};
+	static constexpr std::array<const char*, TYPES.size()> NAMES = {
+		"Entry", "BoolVariable", "IntVariable", "Act", "Fork",
+		"Branch", "Dialogue", "FlavorMatch", "FlavorCheck", "Dice",
+		"AcceptQuest", "ReturnQuest", "Objective"
+	};
+
+	std::array<size_t, TYPES.size()> counts = {};
+	size_t nodes = 0, lines = 0, words = 0, unreachable = 0;
+	auto countWords = [](const std::string& text) {
+		size_t count = 0;
+		bool inWord = false;
+		for (const char c : text)
+		{
+			const bool space = std::isspace(static_cast<unsigned char>(c));
+			count += !space && !inWord ? 1 : 0;
+			inWord = !space;
+		}
+		return count;
+	};
+
+	for (size_t i = 0; i < scene.GetCharacterCount(); i++)
+	{
+		StateMachine state;
+		const DialogueProgram program{ scene.GetCharacter(i), state };
+		nodes += program.Size();
+
+		std::vector<bool> reached(program.Size(), false);
+		std::vector<uint32_t> stack;
+		if (program.GetEntry() != DialogueProgram::END)
+			stack.push_back(program.GetEntry());
+		while (!stack.empty())
+		{
+			const uint32_t pc = stack.back();
+			stack.pop_back();
+			if (pc >= program.Size() || reached[pc])
+				continue;
+			reached[pc] = true;
+			for (const auto successor : program.GetSuccessors(pc))
+				stack.push_back(successor);
+		}
+
+		for (uint32_t pc = 0; pc < program.Size(); pc++)
+		{
+			const auto op = program.GetOpCode(pc);
+			for (size_t t = 0; t < TYPES.size(); t++)
+				counts[t] += TYPES[t] == op ? 1 : 0;
+			unreachable += reached[pc] ? 0 : 1;
+
+			for (const auto& [speaker, line] : program.GetBubbles(pc))
+			{
+				lines++;
+				words += countWords(line);
+			}
+			for (const auto& prompt : program.GetPrompts(pc))
+				words += countWords(prompt);
+		}
+	}
+
+	std::ostringstream oss;
+	oss << scene.GetCharacterCount() << " characters, " << nodes << " nodes, " << lines << " lines, " << words << " words, " << unreachable << " unreachable nodes\n";
+	for (size_t t = 0; t < TYPES.size(); t++)
+		if (counts[t] > 0)
+			oss << "  " << NAMES[t] << ": " << counts[t] << '\n';
+	result.Message = oss.str();
+	result.Message.pop_back();
+	return result;
+}
+
+Result Benchmark(const Options& options, const std::string& input)
+{
+	Result result;
+	Scene scene(true);
+	if (!Load(options, scene, input, result))
+		return result;
+
+	size_t nodes = 0;
+	for (size_t i = 0; i < scene.GetCharacterCount(); i++)
+	{
+		StateMachine state;
+		nodes += DialogueProgram{ scene.GetCharacter(i), state }.Size();
+	}
+
+	// Every thread count exports a few times and keeps its fastest run, the file is removed afterwards
+	static constexpr int RUNS = 3;
+	const std::string output = OutputPath(options, input, ".bench.epuru");
+	const size_t maxThreads = options.Jobs == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : options.Jobs;
+	std::ostringstream oss;
+	oss << nodes << " nodes in " << scene.GetCharacterCount() << " characters";
+	for (size_t threads = 1; threads <= maxThreads; threads++)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (int run = 0; run < RUNS; run++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			if (!ExportSerializer{ &scene, threads }.Serialize(output))
+				return { false, "couldn't write " + output };
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		oss << "\n  " << threads << (threads == 1 ? " thread:  " : " threads: ") << static_cast<uint64_t>(nodes / best) << " nodes/s (" << best * 1000.0 << " ms)";
+	}
+
+	std::error_code error;
+	std::filesystem::remove(output, error);
+	result.Message = oss.str();
+	return result;
+}
+
+Result Simulate(const Options& options, const std::string& input)
+{
+	Result result;
+	Scene scene(true);
+	if (!Load(options, scene, input, result))
+		return result;
+
+	Simulator::Settings settings;
+	settings.Runs = options.Runs;
+	settings.Seed = options.Seed;
+	settings.ThreadCount = options.Jobs;
+
+	std::ostringstream oss;
+	for (size_t i = 0; i < scene.GetCharacterCount(); i++)
+	{
+		// Variables start out set like in the editor's debugger
+		StateMachine state;
+		scene.GetCharacter(i).SetupVariables(state);
+		const DialogueProgram program{ scene.GetCharacter(i), state };
+		if (i > 0)
+			oss << '\n';
+		oss << scene.GetCharacterName(i);
+		if (program.GetEntry() == DialogueProgram::END)
+		{
+			oss << ": no entry node";
+			continue;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		const auto report = Simulator::Run(program, state, settings);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const size_t reached = program.Size() - static_cast<size_t>(std::count(report.Visits.begin(), report.Visits.end(), 0));
+		oss << ": " << report.Runs << " runs in " << seconds * 1000.0 << " ms, " << reached << '/' << program.Size() << " nodes reached\n";
+		oss << "  length: " << report.MinLength << " to " << report.MaxLength << ", " << report.GetMeanLength() << " on average";
+		if (report.Cut > 0)
+			oss << ", " << report.Cut << " cut at " << settings.MaxSteps << " steps";
+		oss << "\n  lengths:";
+		for (size_t bucket = 0; bucket < report.Lengths.size(); bucket++)
+			if (report.Lengths[bucket] > 0)
+				oss << ' ' << (bucket == 0 ? 0 : uint64_t{ 1 } << (bucket - 1)) << '-' << (uint64_t{ 1 } << bucket) - 1 << ": " << report.Lengths[bucket];
+
+		for (uint32_t pc = 0; pc < program.Size(); pc++)
+		{
+			oss << "\n  node " << program.GetInstruction(pc).NodeID << ' ' << DialogueProgram::GetOpName(program.GetOpCode(pc)) << ": " << report.Visits[pc] << " visits";
+			if (report.Visits[pc] == 0)
+			{
+				oss << ", never reached";
+				continue;
+			}
+			if (report.Ends[pc] > 0)
+				oss << ", " << report.Ends[pc] << " ended";
+			const auto successors = program.GetSuccessors(pc);
+			if (successors.size() > 1)
+			{
+				oss << ", outputs";
+				for (uint32_t output = 0; output < successors.size(); output++)
+					oss << ' ' << report.GetTaken(program, pc, output);
+			}
+		}
+	}
+	result.Message = oss.str();
+	return result;
+}
+
+Result Analyze(const Options& options, const std::string& input)
+{
+	Result result;
+	Scene scene(true);
+	if (!Load(options, scene, input, result))
+		return result;
+
+	Analyzer::Settings settings;
+	settings.MemoryLimit = options.Memory;
+	settings.ThreadCount = options.Jobs;
+
+	std::ostringstream oss;
+	size_t problems = 0;
+	for (size_t i = 0; i < scene.GetCharacterCount(); i++)
+	{
+		// Variables start out set like in the editor's debugger
+		StateMachine state;
+		scene.GetCharacter(i).SetupVariables(state);
+		const DialogueProgram program{ scene.GetCharacter(i), state };
+		if (i > 0)
+			oss << '\n';
+		oss << scene.GetCharacterName(i);
+		if (program.GetEntry() == DialogueProgram::END)
+		{
+			oss << ": no entry node";
+			problems++;
+			continue;
+		}
+
+		const auto report = Analyzer::Run(program, state, settings);
+		oss << ": " << report.Stretches << " states explored";
+		auto node = [&program](uint32_t pc) {
+			return "node " + std::to_string(program.GetInstruction(pc).NodeID) + " (" + DialogueProgram::GetOpName(program.GetOpCode(pc)) + ")";
+		};
+
+		// Nothing can be said about what never happens once the exploration was cut short, so the gate can't pass
+		if (!report.Complete)
+		{
+			oss << "\n  stopped at the memory cap, unreached nodes and outputs weren't checked (raise --memory)";
+			problems++;
+		}
+		else
+		{
+			for (uint32_t pc = 0; pc < program.Size(); pc++)
+			{
+				if (!report.Reached[pc])
+				{
+					oss << "\n  " << node(pc) << " is never reached";
+					problems++;
+					continue;
+				}
+				if (program.GetOpCode(pc) != NodeType::Branch)
+					continue;
+				for (uint32_t output = 0; output < program.GetSuccessors(pc).size(); output++)
+				{
+					if (report.IsTaken(program, pc, output))
+						continue;
+					oss << "\n  " << node(pc) << " never takes output " << output;
+					problems++;
+				}
+			}
+		}
+
+		for (const auto& loop : report.Loops)
+		{
+			oss << "\n  endless loop without an Act through";
+			for (const auto pc : loop)
+				oss << ' ' << node(pc);
+			problems++;
+		}
+		for (const auto pc : report.Runaways)
+		{
+			oss << "\n  the flow is still going at " << node(pc) << " after " << settings.MaxStretch << " steps without a Dialogue, Dice or Act";
+			problems++;
+		}
+		for (const auto pc : report.DivisionsByZero)
+		{
+			oss << "\n  " << node(pc) << " divides by zero";
+			problems++;
+		}
+	}
+
+	if (problems > 0)
+		oss << '\n' << problems << " problem(s) found";
+	result.Succeeded = problems == 0;
+	result.Message = oss.str();
+	return result;
+}
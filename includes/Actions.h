@@ -2,9 +2,152 @@
 
 #include "Components.h"
 
+#include <memory>
+#include <variant>
+#include <vector>
+
+class Character;
+
+/**
+* @brief Copy of one node with its pins, enough to bring it back after it was deleted or edited
+* @details Only the node's own components are kept, a whole registry is never copied
+*/
+struct NodeSnapshot {
+    using NodeComponent = std::variant<
+        VariableNode<bool>, VariableNode<int32_t>,
+        ActNode, ForkNode, BranchNode, DialogueNode,
+        FlavorMatchNode, FlavorCheckNode, DiceNode,
+        AcceptQuestNode, ReturnQuestNode, ObjectiveNode,
+        CommentNode
+    >;
+    using PinComponent = std::variant<std::monostate, InputOutput, ForkInputOutput, InputOutputs>;
+
+    NodeComponent Self;
+    PinComponent Pins;
+    ImVec2 Position = { 0.0f, 0.0f };
+
+    [[nodiscard]] ed::NodeId GetID(void) const noexcept;
+    [[nodiscard]] bool IsQuest(void) const noexcept { return std::holds_alternative<AcceptQuestNode>(Self); }
+
+    /**
+    * @brief Approximate memory held by the snapshot, strings and vectors included
+    */
+    [[nodiscard]] size_t GetSize(void) const noexcept;
+};
+
 class IAction {
 public:
-    virtual void MoveForward(void) = 0;
-    virtual void MoveBack(void) = 0;
+    virtual ~IAction(void) = default;
+
+    virtual void MoveForward(Character& character) = 0;
+    virtual void MoveBack(Character& character) = 0;
+
+    /**
+    * @brief Approximate memory held by the action, used to cap the history
+    */
+    [[nodiscard]] virtual size_t GetSize(void) const noexcept = 0;
+};
+
+/**
+* @brief Actions recorded by one user interaction, undone and redone together
+*/
+class GroupAction : public IAction {
+public:
+    void Add(std::unique_ptr<IAction> action) { mActions.emplace_back(std::move(action)); }
+    [[nodiscard]] bool IsEmpty(void) const noexcept { return mActions.empty(); }
+
+    void MoveForward(Character& character) override;
+    void MoveBack(Character& character) override;
+    [[nodiscard]] size_t GetSize(void) const noexcept override;
+
+private:
+    std::vector<std::unique_ptr<IAction>> mActions;
+};
+
+class SpawnNodeAction : public IAction {
+public:
+    SpawnNodeAction(NodeSnapshot node)
+        : mNode(std::move(node)) {}
+
+    void MoveForward(Character& character) override;
+    void MoveBack(Character& character) override;
+    [[nodiscard]] size_t GetSize(void) const noexcept override { return sizeof(*this) - sizeof(mNode) + mNode.GetSize(); }
+
+private:
+    NodeSnapshot mNode;
+};
+
+class DeleteNodeAction : public IAction {
+public:
+    DeleteNodeAction(NodeSnapshot node)
+        : mNode(std::move(node)) {}
+
+    void MoveForward(Character& character) override;
+    void MoveBack(Character& character) override;
+    [[nodiscard]] size_t GetSize(void) const noexcept override { return sizeof(*this) - sizeof(mNode) + mNode.GetSize(); }
+
+private:
+    NodeSnapshot mNode;
+};
+
+/**
+* @brief Change to the fields of one node, its pins included since some fields own outputs
+*/
+class EditNodeAction : public IAction {
+public:
+    EditNodeAction(NodeSnapshot before, NodeSnapshot after)
+        : mBefore(std::move(before)), mAfter(std::move(after)) {}
+
+    void MoveForward(Character& character) override;
+    void MoveBack(Character& character) override;
+    [[nodiscard]] size_t GetSize(void) const noexcept override { return sizeof(*this) - 2 * sizeof(NodeSnapshot) + mBefore.GetSize() + mAfter.GetSize(); }
+
+private:
+    NodeSnapshot mBefore;
+    NodeSnapshot mAfter;
+};
+
+class CreateLinkAction : public IAction {
+public:
+    CreateLinkAction(const Link& link)
+        : mLink(link) {}
+
+    void MoveForward(Character& character) override;
+    void MoveBack(Character& character) override;
+    [[nodiscard]] size_t GetSize(void) const noexcept override { return sizeof(*this); }
+
+private:
+    Link mLink;
+};
+
+class DeleteLinkAction : public IAction {
+public:
+    DeleteLinkAction(const Link& link)
+        : mLink(link) {}
+
+    void MoveForward(Character& character) override;
+    void MoveBack(Character& character) override;
+    [[nodiscard]] size_t GetSize(void) const noexcept override { return sizeof(*this); }
+
+private:
+    Link mLink;
 };
 
+class MoveNodesAction : public IAction {
+public:
+    struct Move {
+        ed::NodeId ID;
+        ImVec2 From;
+        ImVec2 To;
+    };
+
+    MoveNodesAction(std::vector<Move> moves)
+        : mMoves(std::move(moves)) {}
+
+    void MoveForward(Character& character) override;
+    void MoveBack(Character& character) override;
+    [[nodiscard]] size_t GetSize(void) const noexcept override { return sizeof(*this) + mMoves.capacity() * sizeof(Move); }
+
+private:
+    std::vector<Move> mMoves;
+};
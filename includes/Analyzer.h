@@ -0,0 +1,53 @@
+#pragma once
+
+#include "DialogueProgram.h"
+#include "StateMachine.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+* @brief Explores every way a compiled Character can be played, to find what randomized playthroughs miss
+* @details A state is an instruction, both Flavors and every value of the state machine, Fork visits
+*	included. Each of the five Flavors of both speakers is tried when the program checks them, then
+*	every output of Dialogues and Dice is followed, and everything else is executed for real.
+*	Variables only change through VariableNodes, the ones no node of the Character writes keep
+*	their starting value.
+*
+*	Between two Dialogues or Dice the flow is deterministic, so each of those stretches is walked
+*	by one worker, which spots a loop with Brent's cycle detection and a single saved state. The
+*	states a stretch starts from are shared by the workers and never explored twice. They're all
+*	the analysis keeps, so the memory cap applies to them, once it's reached nothing new is queued
+*	and the report is marked incomplete.
+*/
+class Analyzer {
+public:
+
+	struct Settings {
+		size_t MemoryLimit = size_t{ 512 } * 1024 * 1024;//Bytes of explored states
+		uint32_t MaxStretch = 100'000;//Instructions between two Dialogues or Dice before giving up on a stretch
+		size_t ThreadCount = 0;//Zero picks one per hardware thread
+	};
+
+	struct Report {
+		bool Complete = true;//False if the memory cap was reached, nothing reported as never happening can be trusted then
+		uint64_t Stretches = 0;//Distinct states a stretch was explored from
+
+		std::vector<uint8_t> Reached;//By instruction
+		std::vector<uint8_t> Taken;//By output, laid out like the successors of DialogueProgram
+
+		std::vector<std::vector<uint32_t>> Loops;//Instructions of each loop without an Act, sorted
+		std::vector<uint32_t> Runaways;//Where stretches without an Act were given up on after MaxStretch instructions
+		std::vector<uint32_t> DivisionsByZero;//Integer VariableNodes dividing by zero that can be reached
+
+		[[nodiscard]] bool IsTaken(const DialogueProgram& program, uint32_t pc, uint32_t output) const { return Taken[program.GetInstruction(pc).FirstSuccessor + output]; }
+	};
+
+public:
+
+	/**
+	* @brief Explores the program from its entry and blocks until every state is explored or the memory cap is reached
+	* @param initial State the program starts from, it must have been compiled against it
+	*/
+	[[nodiscard]] static Report Run(const DialogueProgram& program, const StateMachine& initial, const Settings& settings);
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "Components.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+
+//Forward Decleration(s)
+namespace YAML { class Emitter; }
+
+/**
+* @brief Read-only view over a binary export (.bpuru)
+* @details The file is a header, followed by a table of sections and the sections themselves.
+*	Every record has a fixed size and refers to other records and to strings by index or
+*	offset, so a runtime can map the file in memory and walk it in place, without parsing
+*	or allocating. All values are little endian and every section is 8-byte aligned.
+*
+*	Nodes of a Character are stored contiguously, grouped by type in the same order the
+*	.epuru export lists them. Each output pin of a node is an Output, which owns a range of
+*	the Targets section; a target is the index of the NodeRecord the output leads to.
+*/
+class BinaryExport {
+public:
+
+	static constexpr char MAGIC[4] = { 'P', 'U', 'R', 'B' };
+	static constexpr uint16_t VERSION_MAJOR = 1;
+	static constexpr uint16_t VERSION_MINOR = 0;
+	static constexpr size_t ALIGNMENT = 8;
+
+	/**
+	* @brief Index value used for "no record"
+	*/
+	static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+	enum class SectionType : uint32_t {
+		Characters = 0,
+		Nodes,
+		Outputs,
+		Targets,
+		Bubbles,
+		Prompts,
+		Expressions,
+		Conditions,
+		Objectives,
+		Strings,
+		Count
+	};
+
+	enum NodeFlags : uint8_t {
+		FLAG_CHECKING_NPC	= 0x01,
+		FLAG_SUCCEED		= 0x02,
+		FLAG_OPTIONAL		= 0x04
+	};
+
+	/**
+	* @brief Range of the string blob, the string is also followed by a null terminator
+	* @details The blob starts with a null terminator, so a default StringRef is an empty string
+	*/
+	struct StringRef {
+		uint32_t Offset = 0;
+		uint32_t Length = 0;
+	};
+
+	struct Header {
+		char Magic[4] = {};
+		uint16_t VersionMajor = 0;
+		uint16_t VersionMinor = 0;
+		uint32_t SectionCount = 0;
+		uint32_t Reserved = 0;
+		uint64_t FileSize = 0;
+	};
+
+	struct Section {
+		SectionType Type = SectionType::Count;
+		uint32_t Count = 0;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+	};
+
+	struct CharacterRecord {
+		StringRef Name;
+		uint32_t FirstNode = 0;
+		uint32_t NodeCount = 0;
+		uint32_t Entry = NONE;
+		uint32_t Reserved = 0;
+	};
+
+	/**
+	* @brief A node of any type
+	* @details The meaning of the type specific fields:
+	*	- Operator/Value/Text: operator, value and name of Variable nodes
+	*	- Text: title of Act and AcceptQuest nodes, Description: description of AcceptQuest nodes
+	*	- UUID: Fork and AcceptQuest identifiers, quest of ReturnQuest and Objective nodes
+	*	- SecondaryUUID: objective of Objective nodes
+	*	- Operands: Bubbles of Act, Prompts of Dialogue, Expressions of Branch and Objectives of AcceptQuest nodes
+	*/
+	struct NodeRecord {
+		uint16_t Type = static_cast<uint16_t>(NodeType::None);
+		uint8_t Operator = 0;
+		uint8_t Flags = 0;
+		int32_t ID = 0;
+		uint32_t FirstOutput = 0;
+		uint32_t OutputCount = 0;
+		uint32_t FirstOperand = 0;
+		uint32_t OperandCount = 0;
+		int32_t Value = 0;
+		uint32_t Reserved = 0;
+		StringRef Text;
+		StringRef Description;
+		uint8_t UUID[16] = {};
+		uint8_t SecondaryUUID[16] = {};
+	};
+
+	struct Output {
+		uint32_t FirstTarget = 0;
+		uint32_t TargetCount = 0;
+	};
+
+	struct Bubble {
+		StringRef Line;
+		uint32_t Speaker = 0;
+		uint32_t Reserved = 0;
+	};
+
+	struct Expression {
+		uint32_t FirstCondition = 0;
+		uint32_t ConditionCount = 0;
+	};
+
+	struct Condition {
+		StringRef Name;
+		uint32_t Operator = 0;
+		int32_t Value = 0;
+	};
+
+	struct Objective {
+		uint8_t UUID[16] = {};
+		StringRef Title;
+		StringRef Description;
+		uint32_t Flags = 0;
+		uint32_t Reserved = 0;
+	};
+
+	static_assert(std::endian::native == std::endian::little, "Binary exports are read and written in place as little endian");
+	static_assert(sizeof(Header) == 24 && sizeof(Section) == 24);
+	static_assert(sizeof(CharacterRecord) == 24 && sizeof(NodeRecord) == 80);
+	static_assert(sizeof(Output) == 8 && sizeof(Bubble) == 16 && sizeof(Expression) == 8);
+	static_assert(sizeof(Condition) == 16 && sizeof(Objective) == 40);
+
+public:
+
+	BinaryExport(void) = default;
+
+	/**
+	* @brief Wraps the bytes of a binary export, usually a mapped file
+	* @details Nothing is copied, the memory must outlive the BinaryExport. Call Validate
+	*	before accessing anything if the bytes come from an untrusted source.
+	*/
+	BinaryExport(const void* data, size_t size) noexcept;
+
+	/**
+	* @brief Checks the header, the section table and every index and offset of the records
+	* @returns nullptr if the export is well formed, otherwise a description of the first problem found
+	*/
+	[[nodiscard]] const char* Validate(void) const noexcept;
+
+	/**
+	* @brief Writes the export back as YAML, in the same layout ExportSerializer::Serialize uses
+	* @details Used to cross-check a binary export against the .epuru of the same project
+	*/
+	void DumpYAML(YAML::Emitter& out) const;
+
+	[[nodiscard]] std::span<const CharacterRecord> GetCharacters(void) const noexcept { return GetSection<CharacterRecord>(SectionType::Characters); }
+	[[nodiscard]] std::span<const NodeRecord> GetNodes(void) const noexcept { return GetSection<NodeRecord>(SectionType::Nodes); }
+	[[nodiscard]] std::span<const Output> GetOutputs(void) const noexcept { return GetSection<Output>(SectionType::Outputs); }
+	[[nodiscard]] std::span<const uint32_t> GetTargets(void) const noexcept { return GetSection<uint32_t>(SectionType::Targets); }
+	[[nodiscard]] std::span<const Bubble> GetBubbles(void) const noexcept { return GetSection<Bubble>(SectionType::Bubbles); }
+	[[nodiscard]] std::span<const StringRef> GetPrompts(void) const noexcept { return GetSection<StringRef>(SectionType::Prompts); }
+	[[nodiscard]] std::span<const Expression> GetExpressions(void) const noexcept { return GetSection<Expression>(SectionType::Expressions); }
+	[[nodiscard]] std::span<const Condition> GetConditions(void) const noexcept { return GetSection<Condition>(SectionType::Conditions); }
+	[[nodiscard]] std::span<const Objective> GetObjectives(void) const noexcept { return GetSection<Objective>(SectionType::Objectives); }
+
+	[[nodiscard]] std::string_view GetString(StringRef ref) const noexcept;
+
+	/**
+	* @brief Gets the nodes a node's output leads to
+	*/
+	[[nodiscard]] std::span<const uint32_t> GetTargets(const NodeRecord& node, uint32_t output) const noexcept;
+
+	/**
+	* @brief Gets the canonical (big endian) bytes of an identifier
+	*/
+	[[nodiscard]] static std::array<uint8_t, 16> EncodeUUID(const gte::uuid& id);
+
+	/**
+	* @brief Formats the bytes written by EncodeUUID the same way gte::uuid::str() does
+	*/
+	[[nodiscard]] static std::string DecodeUUID(const uint8_t(&bytes)[16]);
+
+private:
+
+	[[nodiscard]] const Section* FindSection(SectionType type) const noexcept;
+
+	template<typename T>
+	[[nodiscard]] std::span<const T> GetSection(SectionType type) const noexcept
+	{
+		const Section* section = FindSection(type);
+		if (!section)
+			return {};
+		return { reinterpret_cast<const T*>(mData + section->Offset), section->Count };
+	}
+
+	template<typename T>
+	[[nodiscard]] const char* ValidateSection(SectionType type) const noexcept;
+
+private:
+	const uint8_t* mData = nullptr;
+	size_t mSize = 0;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Scene.h"
+#include "BinaryExport.h"
+
+/**
+* @brief Writes the same content as ExportSerializer::Serialize in the BinaryExport format
+*/
+class BinaryExportSerializer {
+public:
+	BinaryExportSerializer(Scene* scene);
+
+	/**
+	* @brief Exports the Scene, the previous file is only replaced once the export is complete
+	* @returns True if the file was written
+	*/
+	bool Serialize(const std::string& filepath);
+
+private:
+
+	/**
+	* @brief Calls fn(type, registry, entity) for every exported node of a Character, in export order
+	*/
+	template<typename Fn>
+	void EachNode(const Character& character, Fn&& fn) const;
+
+	/**
+	* @brief Gives every node its record index, only the ones of quests have to be known up front
+	*/
+	void AssignRecords(void);
+
+	/**
+	* @brief Builds the table with the target records of every output pin of a Character
+	* @details Follows the same rules as ExportSerializer::BuildTargets, so both exports agree
+	*/
+	void BuildTargets(const Character& character, uint32_t firstNode);
+
+	void WriteNode(NodeType type, const entt::registry& reg, entt::entity entityID);
+	void WriteOutput(const Pin& pin);
+
+	[[nodiscard]] BinaryExport::StringRef AddString(std::string_view str);
+
+private:
+	Scene* mScene = nullptr;
+
+	std::unordered_map<entt::entity, uint32_t> mQuestRecords;
+	std::unordered_map<ed::PinId, uint32_t, IdHash<ed::PinId>> mQuestInputs;
+	std::unordered_map<ed::PinId, std::vector<uint32_t>, IdHash<ed::PinId>> mTargets;
+
+	std::vector<BinaryExport::CharacterRecord> mCharacters;
+	std::vector<BinaryExport::NodeRecord> mNodes;
+	std::vector<BinaryExport::Output> mOutputs;
+	std::vector<uint32_t> mTargetIndices;
+	std::vector<BinaryExport::Bubble> mBubbles;
+	std::vector<BinaryExport::StringRef> mPrompts;
+	std::vector<BinaryExport::Expression> mExpressions;
+	std::vector<BinaryExport::Condition> mConditions;
+	std::vector<BinaryExport::Objective> mObjectives;
+	std::string mStrings;
+};
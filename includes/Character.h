@@ -1,10 +1,13 @@
 #pragma once
 #include <imgui.h>
 
+#include <optional>
 #include <vector>
+#include <unordered_map>
 
 #include "Components.h"
 #include "StateMachine.h"
+#include "History.h"
 
 namespace util = ax::NodeEditor::Utilities;
 namespace ed = ax::NodeEditor;
@@ -17,6 +20,28 @@ struct NodeIdLess
 	}
 };
 
+template<typename T>
+struct IdHash
+{
+	size_t operator()(const T& id) const
+	{
+		return std::hash<uintptr_t>()(id.Get());
+	}
+};
+
+/**
+* @brief Location of a pin inside the ECS
+* @details Slot is the index in the Outputs of the pin's owner or INPUT_SLOT for its Input
+*/
+struct PinRef
+{
+	static constexpr int32_t INPUT_SLOT = -1;
+
+	entt::entity Entity = entt::null;
+	bool InQuestECS = false;
+	int32_t Slot = INPUT_SLOT;
+};
+
 //Forward declarations
 struct Node;
 struct Pin;
@@ -27,6 +52,12 @@ class Character {
 public:
 	Character();
 
+	/**
+	* @brief Creates a Character with the given ID without touching the current node editor
+	* @details Used to build Characters off the main thread, the caller places the nodes afterwards
+	*/
+	explicit Character(size_t id);
+
 	void UpdateTouch(void);
 
 	void RenderNodes(void);
@@ -51,12 +82,9 @@ public:
 	entt::entity SpawnCommentNode(void);
 
 	[[nodiscard]] entt::entity FindEntity(ed::NodeId nodeId) const;
-	[[nodiscard]] std::pair<Node*, NodeType> FindNextNode(int32_t id, StateMachine& state, std::pair<Flavor, Flavor> flavors, int32_t choice = -1);
 
 	template<typename T, typename ...Args>
 	[[nodiscard]] Node* FindNodes(ComponentGroup<T, Args...>, entt::entity entityID) const;
-	[[nodiscard]] NodeType FindNodeType(entt::entity entityID);
-	[[nodiscard]] int32_t GetEntryNodeID(void);
 
 	bool Splitter(bool split_vertically, float thickness, float* size1, float* size2, float min_size1, float min_size2, float splitter_long_axis_size = -1.0f);
 	
@@ -64,31 +92,116 @@ public:
 
 	void SetupVariables(StateMachine& stateMachine) const;
 
+	[[nodiscard]] size_t GetID(void) const noexcept { return mID; }
+
+	/**
+	* @brief Flags the Character as possibly changed, so the next autosave serializes it again
+	*/
+	void MarkDirty(void) noexcept { mRevision++; }
+	[[nodiscard]] uint64_t GetRevision(void) const noexcept { return mRevision; }
+
+	/**
+	* @brief Reverts the last edit recorded in the Character's history
+	* @details Node positions are restored in the current node editor
+	* @returns False if there was nothing to undo
+	*/
+	bool Undo(void);
+	/**
+	* @brief Applies the last undone edit again
+	* @returns False if there was nothing to redo
+	*/
+	bool Redo(void);
+	[[nodiscard]] bool CanUndo(void) const noexcept { return mHistory.CanUndo(); }
+	[[nodiscard]] bool CanRedo(void) const noexcept { return mHistory.CanRedo(); }
+
+	/**
+	* @brief Copies a node with its pins and position, the entry node can't be copied
+	*/
+	[[nodiscard]] std::optional<NodeSnapshot> CaptureNode(ed::NodeId nodeId) const;
+	/**
+	* @brief Brings a node back as it was captured, replacing its current state if it still exists
+	* @param place Whether to also move the node back to where it was captured
+	*/
+	void RestoreNode(const NodeSnapshot& snapshot, bool place);
+	void RemoveNode(ed::NodeId nodeId);
+	void RestoreLink(const Link& link);
+	void RemoveLink(ed::LinkId linkId);
+
 private:
+	struct PinLayout
+	{
+		ed::PinId ID;
+		ed::PinKind Kind;
+		ImVec2 Min;//Relative to the node's position
+		ImVec2 Max;
+	};
+	struct NodeLayout
+	{
+		ImVec2 Position;
+		ImVec2 Size;
+		float HeaderBottom = 0.0f;//Relative to the node's position
+		std::vector<PinLayout> Pins;
+	};
 
 	[[nodiscard]] std::string FindSelectedQuestTitle(const gte::uuid& selection);
 	[[nodiscard]] std::string FindSelectedObjectiveTitle(const gte::uuid& questSelection, const gte::uuid& objectiveSelection);
-	void RenderHeader(NodeBuilder& builder, const char* name, const ImColor& color) const;
-	void RenderInput(NodeBuilder& builder, const Pin& input) const;
-	void RenderOutput(NodeBuilder& builder, const Pin& output) const;
+	void RenderHeader(NodeBuilder& builder, const char* name, const ImColor& color);
+	void RenderInput(NodeBuilder& builder, const Pin& input);
+	void RenderOutput(NodeBuilder& builder, const Pin& output);
+
+	/**
+	* @brief Decides whether a node is rendered in full this frame
+	* @details Nodes whose bounds from their last full render lie outside the visible canvas get
+	*	a placeholder of the same size with the same pins instead, so links, selection and
+	*	dragging keep working without building any of their widgets. Once zoomed out past
+	*	sCompactZoom, visible nodes get one too, drawn as their header and pins only
+	* @returns False if a placeholder was submitted, the node must then be skipped
+	*/
+	[[nodiscard]] bool BeginNodeLayout(ed::NodeId nodeId, const char* name, const ImColor& color);
+	/**
+	* @brief Caches the bounds of the node rendered since BeginNodeLayout, must follow builder.End()
+	*/
+	void EndNodeLayout(void);
+	void RenderCompactNode(ed::NodeId nodeId, const NodeLayout& layout, const char* name, const ImColor& color) const;
 	
 	template<typename T>
 	void RenderVariableNode(NodeBuilder& builder);
 
 	[[nodiscard]] entt::entity FindEntity(ed::PinId pinId) const;
+	[[nodiscard]] bool IsQuestNode(ed::NodeId nodeId, entt::entity entityID) const;
 
-
-	template<typename T>
-	[[nodiscard]] entt::entity SearchEntity(ed::NodeId nodeId) const;
-
+	/**
+	* @brief Records the edit of the last ImGui item in the history
+	* @details Typing and dragging go on for many frames, the node is captured when the item
+	*	is activated and recorded once when it's released, as a single entry
+	*/
+	void TrackEdit(ed::NodeId nodeId);
+	/**
+	* @brief Records a node that was just edited, given its state from before the edit
+	*/
+	void RecordEdit(std::optional<NodeSnapshot> before);
+	/**
+	* @brief Records the nodes moved by dragging, once the mouse is released
+	*/
+	void TrackMoves(void);
 
 	[[nodiscard]] Pin FindPin(entt::entity entityID, ed::PinId pinId) const;
+	[[nodiscard]] const Pin* LookupPin(ed::PinId pinId) const;
+	[[nodiscard]] Pin* LookupPin(ed::PinId pinId) { return const_cast<Pin*>(std::as_const(*this).LookupPin(pinId)); }
+
+	void IndexPins(entt::entity entityID, bool inQuestECS = false);
+	void UnindexPins(entt::entity entityID, bool inQuestECS = false);
+	void IndexNode(const Node& node, entt::entity entityID) { mNodeIndex[node.ID] = entityID; }
+	void IndexLink(entt::entity entityID);
+	void UnindexLink(entt::entity entityID);
+	void ValidateIndices(void) const;
 	
 	template<typename T>
 	[[nodiscard]] Node* FindNode(entt::entity entityID) const;
 	
 	[[nodiscard]] Link* FindLink(ed::LinkId linkID);
-	[[nodiscard]] Link* FindLink(ed::PinId pinID);
+	[[nodiscard]] const Link* FindLink(ed::PinId pinID) const;
+	[[nodiscard]] Link* FindLink(ed::PinId pinID) { return const_cast<Link*>(std::as_const(*this).FindLink(pinID)); }
 	
 	//[[nodiscard]] const Pin FindPin(entt::entity entityID, ed::PinId pinId) const;
 	
@@ -108,6 +221,15 @@ private:
 private:
 	size_t mID;
 	entt::registry mECS;
+	std::unordered_map<ed::PinId, PinRef, IdHash<ed::PinId>> mPinIndex;
+	std::unordered_map<ed::NodeId, entt::entity, IdHash<ed::NodeId>> mNodeIndex;
+	std::unordered_map<ed::PinId, std::vector<entt::entity>, IdHash<ed::PinId>> mOutgoingLinks;
+	std::unordered_map<ed::PinId, std::vector<entt::entity>, IdHash<ed::PinId>> mIncomingLinks;
+	std::unordered_map<ed::NodeId, NodeLayout, IdHash<ed::NodeId>> mNodeLayouts;
+	NodeLayout* mCurrentLayout = nullptr;
+	ImVec2 mVisibleMin;//Visible canvas this frame, margin included
+	ImVec2 mVisibleMax;
+	float mZoom = 1.0f;//Canvas units per screen pixel, grows when zooming out
 
 	ed::NodeId mContextNodeId;
 	ed::LinkId mContextLinkId;
@@ -117,17 +239,28 @@ private:
 	Pin* mNewNodeLinkPin = nullptr;
 	Pin* mNewLinkPin = nullptr;
 	int32_t mNextID = 1;
+	uint64_t mRevision = 1;
+	bool mWasEditing = false;//An item was active last frame, its edit may only land on release
+	History mHistory;
+	std::optional<NodeSnapshot> mEditBefore;//Node of the item being edited, as it was when the item got active
+	ImGuiID mEditItem = 0;
+	std::vector<MoveNodesAction::Move> mMoveStart;//Selected nodes, as they were before they could be dragged
 	entt::entity mOpenActNode = entt::null;
 	entt::entity mOpenAcceptQuest = entt::null;
 	std::pair<entt::entity, int32_t> mOpenExpression = { entt::null, -1 };
 	
 	static constexpr float sTouchTime = 1.0f;
+	static constexpr float sCullMargin = 128.0f;
+	static constexpr float sCompactZoom = 2.0f;
 
-	static entt::registry sQuestECS;
-	static size_t sNextID;
+	// Per thread, so headless tools can load several projects at once
+	static thread_local entt::registry sQuestECS;
+	static thread_local size_t sNextID;
 
 	friend class SceneSerializer;
 	friend class ExportSerializer;
+	friend class BinaryExportSerializer;
+	friend class DialogueProgram;
 };
 
 #include <Character.hpp>
\ No newline at end of file
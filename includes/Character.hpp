@@ -20,25 +20,6 @@ inline const ImVec2 OPERATOR_BUTTON_SIZE = { 32.0f, 28.0f };
 //	BuildNodes<Args...>();
 //}
 
-template<typename T>
-[[nodiscard]] inline entt::entity Character::SearchEntity(ed::NodeId nodeId) const
-{
-	auto view = mECS.view<T>();
-	for (auto&& [entityID, node] : view.each())
-		if (node.ID == nodeId)
-			return entityID;
-	return entt::null;
-}
-
-template<>
-[[nodiscard]] inline entt::entity Character::SearchEntity<AcceptQuestNode>(ed::NodeId nodeId) const {
-	auto view = sQuestECS.view<AcceptQuestNode>();
-	for (auto&& [entityID, node] : view.each())
-		if (node.ID == nodeId)
-			return entityID;
-	return entt::null;
-}
-
 template<typename T>
 [[nodiscard]] inline Node* Character::FindNode(entt::entity entityID) const
 {
@@ -76,6 +57,9 @@ inline void Character::RenderVariableNode(NodeBuilder& builder)
 
 	for (auto&& [entityID, node] : view.each())
 	{
+		if (!BeginNodeLayout(node.ID, VariableNode<T>::NAME, VariableNode<T>::COLOR))
+			continue;
+
 		ImGui::PushID((int32_t)(int64_t)node.ID.AsPointer());
 		builder.Begin(node.ID);
 		RenderHeader(builder, VariableNode<T>::NAME, VariableNode<T>::COLOR);
@@ -87,6 +71,7 @@ inline void Character::RenderVariableNode(NodeBuilder& builder)
 
 		ImGui::PushItemWidth(128.0f);
 		ImGui::InputText("##name", node.VariableName, STR_LENGTH);
+		TrackEdit(node.ID);
 		ImGui::PopItemWidth();
 		ImGui::SameLine();
 
@@ -96,6 +81,7 @@ inline void Character::RenderVariableNode(NodeBuilder& builder)
 			ImGui::TextUnformatted("=");
 			ImGui::SameLine();
 			ImGui::Checkbox("##value", &node.Value);
+			TrackEdit(node.ID);
 		}
 		else if constexpr (std::is_same<T, int32_t>::value)
 		{
@@ -104,11 +90,13 @@ inline void Character::RenderVariableNode(NodeBuilder& builder)
 			ImGui::SameLine();
 			ImGui::PushItemWidth(64.0f);
 			ImGui::DragScalar("##value", ImGuiDataType_S32, &node.Value, 1.0f);
+			TrackEdit(node.ID);
 			ImGui::PopItemWidth();
 		}
 		ImGui::Spring(0.0f, 1.0f);
 		RenderOutput(builder, pins.Output);
 		builder.End();
+		EndNodeLayout();
 
 		ed::Suspend();
 		if (pressOperator)
@@ -117,8 +105,14 @@ inline void Character::RenderVariableNode(NodeBuilder& builder)
 		if (ImGui::BeginPopup("Operator"))
 		{
 			for (int32_t i = 0; i < IM_ARRAYSIZE(operators); i++)
+			{
 				if (ImGui::MenuItem(operators[i]))
+				{
+					auto before = CaptureNode(node.ID);
 					node.Operator = static_cast<SetOperator>(i);
+					RecordEdit(std::move(before));
+				}
+			}
 			ImGui::EndPopup();
 		}
 		ed::Resume();
@@ -131,6 +125,7 @@ template<typename T>
 {
 	const auto entityID = mECS.create();
 	auto& node = mECS.emplace<VariableNode<T>>(entityID, GetNextID());
+	IndexNode(node, entityID);
 
 	auto& pins = mECS.emplace<InputOutput>(entityID);
 	pins.Input = { GetNextID(), "", PinType::Flow };
@@ -139,5 +134,6 @@ template<typename T>
 	pins.Output = { GetNextID(), "", PinType::Flow };
 	pins.Output.Kind = PinKind::Output;
 
+	IndexPins(entityID);
 	return entityID;
 }
\ No newline at end of file
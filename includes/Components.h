@@ -327,6 +327,11 @@ YAML::Emitter& operator<<(YAML::Emitter& emitter, const std::array<Pin, 2>& pins
 YAML::Emitter& operator<<(YAML::Emitter& emitter, const std::vector<Pin>& pins) noexcept;
 YAML::Emitter& operator<<(YAML::Emitter& emitter, const ImVec2& vec) noexcept;
 
+/**
+* @brief Checks whether two flavors match, meaning they are the same or one is part of the other's combination
+*/
+[[nodiscard]] bool IsFlavorMatching(Flavor lhs, Flavor rhs);
+
 template<typename ...T>
 struct ComponentGroup{};
 
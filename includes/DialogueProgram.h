@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Components.h"
+#include "StateMachine.h"
+#include "Random.h"
+
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+class Character;
+
+/**
+* @brief Immutable, flat representation of a Character's dialogue graph
+* @details Every node that takes part in the flow is lowered to one Instruction stored
+*	contiguously. Links are resolved at compile time into indices of other
+*	instructions, so stepping through the program never touches the editor's ECS.
+*/
+class DialogueProgram {
+public:
+
+	/**
+	* @brief Program counter value used for "no next node"
+	*/
+	static constexpr uint32_t END = std::numeric_limits<uint32_t>::max();
+
+	struct Instruction {
+		NodeType Op = NodeType::None;
+		int32_t NodeID = 0;
+		uint32_t FirstSuccessor = 0;
+		uint32_t SuccessorCount = 0;
+		uint32_t FirstOperand = 0;
+		uint32_t OperandCount = 0;
+		int32_t Value = 0;
+		StateMachine::Slot Variable = 0;
+		SetOperator Operator = SetOperator::Assignment;
+		bool CheckingNPC = false;
+	};
+
+	struct CompiledCondition {
+		StateMachine::Slot Variable = 0;
+		CompareOperator Operator = CompareOperator::Equality;
+		int32_t Value = 0;
+	};
+
+	struct CompiledExpression {
+		uint32_t FirstCondition = 0;
+		uint32_t ConditionCount = 0;
+	};
+
+public:
+
+	DialogueProgram(void) = default;
+
+	/**
+	* @brief Compiles a Character's graph, including the quests it owns
+	* @details Variable names and forks are resolved to slots of the given state machine
+	*/
+	DialogueProgram(const Character& character, StateMachine& state);
+
+	/**
+	* @brief Executes the instruction at pc and returns the index of the next one
+	* @details Each step does a constant amount of work apart from evaluating a
+	*	Branch's conditions, and never allocates.
+	* @param random Generator of the session, Dice roll with it
+	* @param choice Prompt picked by the player when pc points to a Dialogue
+	*/
+	[[nodiscard]] uint32_t Step(uint32_t pc, StateMachine& state, std::pair<Flavor, Flavor> flavors, Random& random, int32_t choice = -1) const
+	{
+		return pc < mInstructions.size() ? Successor(mInstructions[pc], Execute(pc, state, flavors, random, choice)) : END;
+	}
+
+	/**
+	* @brief Same as Step, but tells which output of the instruction was taken
+	* @returns Index of the output among GetSuccessors(pc), END if the flow stops there
+	*/
+	[[nodiscard]] uint32_t Execute(uint32_t pc, StateMachine& state, std::pair<Flavor, Flavor> flavors, Random& random, int32_t choice = -1) const;
+
+	[[nodiscard]] uint32_t GetEntry(void) const noexcept { return mEntry; }
+	[[nodiscard]] NodeType GetOpCode(uint32_t pc) const noexcept { return pc < mInstructions.size() ? mInstructions[pc].Op : NodeType::None; }
+	[[nodiscard]] const Instruction& GetInstruction(uint32_t pc) const { return mInstructions[pc]; }
+	[[nodiscard]] size_t Size(void) const noexcept { return mInstructions.size(); }
+
+	[[nodiscard]] std::span<const uint32_t> GetSuccessors(uint32_t pc) const noexcept
+	{
+		if (pc >= mInstructions.size())
+			return {};
+		return { mSuccessors.data() + mInstructions[pc].FirstSuccessor, mInstructions[pc].SuccessorCount };
+	}
+
+	[[nodiscard]] std::span<const std::pair<Speaker, std::string>> GetBubbles(uint32_t pc) const;
+	[[nodiscard]] std::span<const std::string> GetPrompts(uint32_t pc) const;
+
+	/**
+	* @brief Name of the node an instruction comes from, as shown in the editor
+	*/
+	[[nodiscard]] static const char* GetOpName(NodeType op) noexcept;
+
+private:
+
+	[[nodiscard]] uint32_t Successor(const Instruction& instruction, size_t index) const noexcept
+	{
+		return index < instruction.SuccessorCount ? mSuccessors[instruction.FirstSuccessor + index] : END;
+	}
+
+	[[nodiscard]] bool Evaluate(const CompiledExpression& expression, const StateMachine& state) const;
+
+private:
+
+	std::vector<Instruction> mInstructions;
+	std::vector<uint32_t> mSuccessors;
+
+	std::vector<CompiledExpression> mExpressions;
+	std::vector<CompiledCondition> mConditions;
+	std::vector<std::pair<Speaker, std::string>> mBubbles;
+	std::vector<std::string> mPrompts;
+
+	uint32_t mEntry = END;
+};
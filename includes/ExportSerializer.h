@@ -7,35 +7,42 @@ namespace YAML { class Emitter; }
 
 class ExportSerializer {
 public:
-	ExportSerializer(Scene* scene);
+	/**
+	* @param threadCount Number of Characters emitted at once, 0 uses one per hardware thread
+	*/
+	ExportSerializer(Scene* scene, size_t threadCount = 0);
 
-	void Serialize(const std::string& filepath);
-	void SerializeLines(const std::string& filepath);
+	/**
+	* @brief Exports the Scene, the previous file is only replaced once the export is complete
+	* @details Characters are emitted in parallel into their own documents, which are written in order,
+	*	so the file is the same for any thread count
+	* @returns True if the file was written
+	*/
+	bool Serialize(const std::string& filepath);
+	bool SerializeLines(const std::string& filepath);
 
 private:
+	using TargetTable = std::unordered_map<ed::PinId, std::vector<uint64_t>, IdHash<ed::PinId>>;
 
-    [[nodiscard]] std::vector<uint64_t> FindTargets(const entt::registry& reg, const Pin& pin)
-	{
-		const ed::NodeId INVALID_ID = ed::NodeId{ 0 };
-		std::vector<uint64_t> data;
-		auto view = reg.view<Link>();
-		for (auto&& [entityID, link] : view.each())
-		{
-			if (link.StartPinID == pin.ID)
-			{
-				Node* node = FindNode(reg, link.EndPinID);
-				if (node && node->ID != INVALID_ID)
-					data.emplace_back((uint64_t)node->ID.AsPointer());
-			}
-		}
-
-		if (data.empty())
-			data.emplace_back(0);
-
-		return data;
-	}
+	/**
+	* @brief Emits one entry of the Characters sequence
+	* @details Only reads the Scene and the quest inputs, so it runs on any thread as long as quests
+	*	is the registry of the thread that owns the Scene
+	*/
+	void SerializeCharacter(YAML::Emitter& out, const Scene::CharacterData& characterData, const entt::registry& quests) const;
+
+	/**
+	* @brief Builds the table with the target nodes of every output pin of a Character
+	* @details Done once per Character, so emitting the nodes afterwards is a single linear pass
+	*/
+	void BuildTargets(const Character& character, TargetTable& targetTable) const;
+
+	/**
+	* @brief Builds the table with the AcceptQuest node of every quest input pin
+	*/
+	void BuildQuestInputs(void);
 
-	[[nodiscard]] Node* FindNode(const entt::registry& reg, ed::PinId pinId);
+	[[nodiscard]] static const std::vector<uint64_t>& FindTargets(const TargetTable& targetTable, const Pin& pin);
 
 	template<typename T>
 	[[nodiscard]] Node* FindNode(const entt::registry& reg, entt::entity entityID) const
@@ -59,4 +66,6 @@ private:
 
 private:
 	Scene* mScene = nullptr;
+	size_t mThreadCount = 0;
+	std::unordered_map<ed::PinId, uint64_t, IdHash<ed::PinId>> mQuestInputs;
 };
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+* @brief Writes a file through a reusable in-memory buffer and swaps it in atomically
+* @details Text goes to GetStream() and stays in memory until Flush() moves it to a
+*	temporary file next to the target, keeping the buffer's capacity for the next chunk.
+*	Commit() renames the temporary file over the target, so readers either see the old
+*	file or the complete new one. If Commit() isn't reached the temporary file is removed.
+*/
+class FileWriter {
+public:
+	FileWriter(const std::string& filepath, std::ios::openmode mode = std::ios::out);
+	~FileWriter(void) noexcept;
+
+	FileWriter(const FileWriter&) = delete;
+	FileWriter& operator=(const FileWriter&) = delete;
+
+	[[nodiscard]] std::ostream& GetStream(void) noexcept { return mStream; }
+
+	/**
+	* @brief Moves everything written so far to the temporary file
+	*/
+	void Flush(void);
+
+	/**
+	* @brief Flushes, closes and renames the temporary file over the target
+	* @returns True if the target now holds everything that was written
+	*/
+	bool Commit(void);
+
+private:
+
+	class Buffer : public std::streambuf {
+	public:
+		Buffer(void);
+
+		[[nodiscard]] const char* Data(void) const noexcept { return pbase(); }
+		[[nodiscard]] size_t Size(void) const noexcept { return static_cast<size_t>(pptr() - pbase()); }
+		void Reset(void) noexcept { setp(mData.data(), mData.data() + mData.size()); }
+
+	protected:
+		int_type overflow(int_type ch) override;
+		std::streamsize xsputn(const char* data, std::streamsize count) override;
+
+	private:
+		void Grow(size_t required);
+		void Advance(size_t count);
+
+	private:
+		std::vector<char> mData;
+	};
+
+private:
+	std::string mFilepath;
+	std::string mTempFilepath;
+	std::ofstream mFile;
+	Buffer mBuffer;
+	std::ostream mStream;
+	bool mCommitted = false;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Actions.h"
+
+#include <deque>
+#include <memory>
+
+/**
+* @brief Undo and redo history of one Character
+* @details Entries are kept oldest first, up to a memory budget. Once it's exceeded the
+*	oldest entries are dropped, like in a ring buffer. Actions pushed between BeginGroup and
+*	EndGroup become one entry, so a single interaction is undone in one step.
+*/
+class History {
+public:
+
+	static constexpr size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;
+
+public:
+	History(size_t capacity = DEFAULT_CAPACITY)
+		: mCapacity(capacity) {}
+
+	History(History&&) noexcept = default;
+	History& operator=(History&&) noexcept = default;
+
+	/**
+	* @brief Records an action that was already carried out, dropping everything that could be redone
+	*/
+	void Push(std::unique_ptr<IAction> action);
+
+	void BeginGroup(void);
+	void EndGroup(void);
+
+	/**
+	* @returns False if there was nothing to undo
+	*/
+	bool Undo(Character& character);
+	/**
+	* @returns False if there was nothing to redo
+	*/
+	bool Redo(Character& character);
+
+	[[nodiscard]] bool CanUndo(void) const noexcept { return mCursor > 0; }
+	[[nodiscard]] bool CanRedo(void) const noexcept { return mCursor < mEntries.size(); }
+	[[nodiscard]] size_t GetSize(void) const noexcept { return mSize; }
+
+	void Clear(void) noexcept;
+
+private:
+	std::deque<std::unique_ptr<IAction>> mEntries;
+	size_t mCursor = 0;//Entries before it are done, entries from it on are undone
+	size_t mSize = 0;
+	size_t mCapacity;
+	std::unique_ptr<GroupAction> mGroup;
+	size_t mGroupDepth = 0;
+};
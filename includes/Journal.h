@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+/**
+* @brief Append-only log of the Characters changed since a project was last written in full
+* @details Lives next to the project as <project>.journal. It starts with a Base record holding the
+*	size and write time of the project it applies to, along with the IDs of the project's Characters
+*	in file order. Every Character record holds the complete YAML of one Character and replaces any
+*	earlier version of it. Order records list the Characters that exist, in order, whenever that
+*	changes. Each record is framed with its size and a checksum, so a record cut short by a crash
+*	ends the journal instead of corrupting it.
+*/
+class Journal {
+public:
+
+	enum class RecordType : char {
+		Base = 'B',
+		Order = 'O',
+		Character = 'C'
+	};
+
+	struct Record {
+		RecordType Type = RecordType::Base;
+		size_t CharacterID = 0;
+		std::vector<size_t> Order;//Base and Order records
+		std::string Payload;//Character records
+	};
+
+	/**
+	* @brief Journals never need a rewrite below this size, however small the project
+	*/
+	static constexpr size_t MIN_REWRITE_SIZE = 1024 * 1024;
+
+public:
+	Journal(void) = default;
+	~Journal(void) noexcept;
+
+	Journal(const Journal&) = delete;
+	Journal& operator=(const Journal&) = delete;
+
+	/**
+	* @brief Starts a new journal for a project that was just written in full or opened
+	* @details The previous journal is replaced by the next Flush, records appended before it are dropped
+	* @param order IDs of the project's Characters, in the order they are in the file
+	*/
+	void Reset(const std::string& projectPath, const std::vector<size_t>& order);
+
+	void AppendOrder(const std::vector<size_t>& order);
+	void AppendCharacter(size_t characterID, const std::string& yaml);
+
+	/**
+	* @brief Writes the appended records on a background thread
+	* @details Does nothing while the previous flush is still running, its records go out with the next one
+	*/
+	void Flush(void);
+
+	[[nodiscard]] bool IsOpen(void) const noexcept { return !mFilepath.empty(); }
+
+	/**
+	* @brief The project should be written in full once the journal outgrows it, or if a flush failed
+	*/
+	[[nodiscard]] bool NeedsRewrite(void) const noexcept { return mFailed || mSize > std::max(mBaseSize, MIN_REWRITE_SIZE); }
+
+	[[nodiscard]] static std::string GetFilepath(const std::string& projectPath) { return projectPath + ".journal"; }
+
+	/**
+	* @brief Reads the journal of a project, up to its first incomplete record
+	* @returns Nothing if there's no journal or it was started from another version of the project,
+	*	otherwise the Base record comes first
+	*/
+	[[nodiscard]] static std::vector<Record> Read(const std::string& projectPath);
+
+private:
+
+	void Append(RecordType type, size_t characterID, const std::string& payload);
+	void Wait(void) noexcept;
+
+	static bool Write(const std::string& filepath, const std::string& records, bool truncate);
+
+	/**
+	* @returns Size and write time of the project, empty if it doesn't exist
+	*/
+	[[nodiscard]] static std::string Stamp(const std::string& projectPath);
+
+private:
+	std::string mFilepath;
+	std::string mPending;//Records appended since the last flush
+	bool mTruncate = false;//The next flush replaces the file instead of appending to it
+	bool mFailed = false;
+	std::future<bool> mWriting;
+	size_t mSize = 0;
+	size_t mBaseSize = 0;
+};
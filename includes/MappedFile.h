@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+* @brief Read-only memory mapping of a whole file
+* @details The mapping is released when the MappedFile is destroyed
+*/
+class MappedFile {
+public:
+	MappedFile(void) = default;
+
+	/**
+	* @brief Maps the given file
+	* @warnings IsOpen returns false if the file couldn't be opened or is empty
+	*/
+	MappedFile(const std::string& filepath);
+	~MappedFile(void) noexcept;
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	[[nodiscard]] bool IsOpen(void) const noexcept { return mData != nullptr; }
+	[[nodiscard]] const void* Data(void) const noexcept { return mData; }
+	[[nodiscard]] size_t Size(void) const noexcept { return mSize; }
+
+private:
+	const void* mData = nullptr;
+	size_t mSize = 0;
+#ifdef PLATFORM_WINDOWS
+	void* mFile = nullptr;
+	void* mMapping = nullptr;
+#endif
+};
@@ -1,20 +1,46 @@
 #pragma once
 
+#include <cstdint>
+
 /**
-* @brief Helper Class for random number generation
+* @brief Small and fast seedable random number generator (PCG32)
+* @details Every runtime session owns its own, so sessions on different threads never share
+*	state and the same seed and stream replay a session exactly. Sixteen bytes of state,
+*	cheap to copy and to create per worker.
 */
 class Random {
 public:
 
+	Random(uint64_t seed = 0, uint64_t stream = 0) noexcept { Seed(seed, stream); }
+
+	/**
+	* @brief Restarts the sequence
+	* @param stream Picks one of 2^63 independent sequences for the same seed, like one per worker
+	*/
+	void Seed(uint64_t seed, uint64_t stream = 0) noexcept;
+
 	/**
-	* @brief Initializing the Random generator
+	* @brief Seed drawn from the system's entropy source, for sessions that don't need to be replayed
 	*/
-	static void Init(void);
+	[[nodiscard]] static uint64_t RandomSeed(void);
+
+	[[nodiscard]] uint32_t Next(void) noexcept;
 
 	/**
-	* @brief Generates a random float in range [0.0f, 1.0f]
+	* @brief Generates an integer in range [0, bound) without modulo bias
+	* @details Lemire's multiply and shift, a second draw is only needed for a few bounds and rarely
+	*/
+	[[nodiscard]] uint32_t Below(uint32_t bound) noexcept;
+
+	/**
+	* @brief Generates a random float in range [0.0f, 1.0f)
 	* @details Numbers generate by this function follow a uniform distrubution
 	*/
-	static float Float(void);
+	[[nodiscard]] float Float(void) noexcept;
+
+private:
+	uint64_t mState = 0;
+	uint64_t mIncrement = 1;//Always odd, selects the stream
+};
 
-};
\ No newline at end of file
+#include "Random.hpp"
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Random.h"
+
+#include <bit>
+
+inline void Random::Seed(uint64_t seed, uint64_t stream) noexcept
+{
+	mState = 0;
+	mIncrement = (stream << 1) | 1;
+	(void)Next();
+	mState += seed;
+	(void)Next();
+}
+
+[[nodiscard]] inline uint32_t Random::Next(void) noexcept
+{
+	const uint64_t state = mState;
+	mState = state * 6364136223846793005ULL + mIncrement;
+	const uint32_t xorshifted = static_cast<uint32_t>(((state >> 18) ^ state) >> 27);
+	return std::rotr(xorshifted, static_cast<int>(state >> 59));
+}
+
+[[nodiscard]] inline uint32_t Random::Below(uint32_t bound) noexcept
+{
+	uint64_t product = uint64_t{ Next() } * bound;
+	uint32_t low = static_cast<uint32_t>(product);
+	if (low < bound)
+	{
+		// Draws landing in the first 2^32 % bound values would make the smaller results more likely
+		const uint32_t threshold = (0u - bound) % bound;
+		while (low < threshold)
+		{
+			product = uint64_t{ Next() } * bound;
+			low = static_cast<uint32_t>(product);
+		}
+	}
+	return static_cast<uint32_t>(product >> 32);
+}
+
+[[nodiscard]] inline float Random::Float(void) noexcept
+{
+	// The top 24 bits fill a float's mantissa exactly, so 1.0f can't come out
+	return static_cast<float>(Next() >> 8) * 0x1.0p-24f;
+}
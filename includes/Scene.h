@@ -2,12 +2,21 @@
 
 #include "Character.h"
 #include "StateMachine.h"
+#include "DialogueProgram.h"
+#include "Journal.h"
+#include "Simulator.h"
 
 #include <imgui_node_editor.h>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
 
 namespace ed = ax::NodeEditor;
 
 class Scene {
+	struct PendingOpen;
+	struct Simulation;
+
 	struct CharacterData{
 		char Name[64] = "Unnamed Character";
 		Character Self;
@@ -16,7 +25,17 @@ class Scene {
 
 		CharacterData(void) = default;
 		CharacterData(ed::EditorContext* editor)
-			: Editor(editor), Self({}) {}
+			: Editor(editor), Self() {}
+		explicit CharacterData(size_t characterID)
+			: Self(characterID) {}
+	};
+
+	/**
+	* @brief What the journal last got of a Character
+	*/
+	struct JournaledCharacter {
+		uint64_t Revision = 0;
+		size_t Hash = 0;//Of the YAML, 0 if it's the one in the project file
 	};
 
 public:
@@ -31,21 +50,57 @@ public:
 	static constexpr size_t VARIABLE_INDEX = 5;
 	
 	static constexpr size_t QUEST_INDEX = 6;
-	static std::array<bool, 7> sWindows;
+	static constexpr size_t SIMULATION_INDEX = 7;
+	static std::array<bool, 8> sWindows;
 
 public:
 
-	Scene(void);
+	/**
+	* @param headless Skips creating node editors, so the Scene can be loaded and exported without a renderer
+	*/
+	Scene(bool headless = false);
 	~Scene(void) noexcept;
 
 	void RenderFrame(void) noexcept;
 
+	[[nodiscard]] bool IsHeadless(void) const noexcept { return mHeadless; }
+	[[nodiscard]] size_t GetCharacterCount(void) const noexcept { return mAllData.size(); }
+	[[nodiscard]] const Character& GetCharacter(size_t index) const { return mAllData[index].Self; }
+	[[nodiscard]] const char* GetCharacterName(size_t index) const { return mAllData[index].Name; }
+
 private:
 
 	void ShowPanels();
+	/**
+	* @brief Undoes the last edit of the Character being worked on
+	*/
+	void Undo(void);
+	void Redo(void);
 	void SaveAs();
 	void Save();
 	void Open();
+	/**
+	* @brief Shows the progress of the file being opened and replaces the Scene once it's loaded
+	*/
+	void UpdateOpen(void);
+
+	/**
+	* @brief Compiles a Character and plays it at random in the background, see Simulator
+	*/
+	void StartSimulation(size_t index, const Simulator::Settings& settings);
+	void ShowSimulation(void);
+
+	/**
+	* @brief Journals the Characters edited since the last autosave, every few seconds
+	* @details The project is written in full instead once the journal gets too big
+	*/
+	void Autosave(void);
+	/**
+	* @brief Starts the journal over once the project file is up to date
+	* @param replayed Records replayed on Open that still aren't in the file
+	*/
+	void ResetJournal(const std::vector<Journal::Record>& replayed = {});
+	[[nodiscard]] std::vector<size_t> GetCharacterOrder(void) const;
 
 private:
 
@@ -57,8 +112,20 @@ private:
 	bool mSpeaking = false;
 	bool mDone = false;
 	int32_t mChoice = -1;
-	int32_t mDebugingID = 0;
+	DialogueProgram mProgram;
+	uint32_t mProgramCounter = DialogueProgram::END;
 	StateMachine mStateMachine;
+	Random mRandom;//Dice of the session being debugged
+	uint64_t mSeed = 0;//Of the next session, zero draws a new one every time
+	uint64_t mSessionSeed = 0;
+	bool mHeadless = false;
+	std::unique_ptr<PendingOpen> mPendingOpen;
+	std::unique_ptr<Simulation> mSimulation;
+	Journal mJournal;
+	std::unordered_map<size_t, JournaledCharacter> mJournaled;//By Character ID
+	std::vector<size_t> mJournaledOrder;
+	std::chrono::steady_clock::time_point mLastAutosave;
 	friend class SceneSerializer;
 	friend class ExportSerializer;
+	friend class BinaryExportSerializer;
 };
\ No newline at end of file
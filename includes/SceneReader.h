@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Components.h"
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/mark.h>
+
+#include <array>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+/**
+* @brief Reads .puru files from the events of the YAML parser, without building a YAML::Node tree
+* @details The scalars of a node are gathered in buffers reused from one node to the next and
+*	converted to components as soon as the node's map ends. Each Character is handed over once its
+*	map ends, so only the Character being read is held at a time. Fields are read and converted
+*	the same way the YAML::Node loader used to, fields a node doesn't use are skipped.
+*/
+class SceneReader final : public YAML::EventHandler {
+public:
+
+	/**
+	* @brief A node's components and the position of the node in the editor
+	*/
+	template<typename TNode, typename TPins = std::monostate>
+	struct Record {
+		TNode Component;
+		TPins Pins;
+		ImVec2 Position;
+	};
+
+	/**
+	* @brief Variables of an unknown type only get their pins
+	*/
+	using VariableComponent = std::variant<std::monostate, VariableNode<bool>, VariableNode<int32_t>>;
+
+	/**
+	* @brief Every node of a Character, each list in the order of the file
+	*/
+	struct CharacterRecord {
+		std::string Name;
+		int32_t NextID = 1;//Greatest ID used by the nodes, pins and links
+		std::vector<Record<Node, Pin>> EntryNodes;
+		std::vector<Record<VariableComponent, InputOutput>> VariableNodes;
+		std::vector<Record<ActNode, InputOutput>> ActNodes;
+		std::vector<Record<ForkNode, ForkInputOutput>> ForkNodes;
+		std::vector<Record<BranchNode, InputOutputs>> BranchNodes;
+		std::vector<Record<DialogueNode, InputOutputs>> DialogueNodes;
+		std::vector<Record<FlavorMatchNode, ForkInputOutput>> FlavorMatchNodes;
+		std::vector<Record<FlavorCheckNode, InputOutputs>> FlavorCheckNodes;
+		std::vector<Record<DiceNode, InputOutputs>> DiceNodes;
+		std::vector<Record<AcceptQuestNode, InputOutput>> AcceptQuestNodes;
+		std::vector<Record<ReturnQuestNode, InputOutput>> ReturnQuestNodes;
+		std::vector<Record<ObjectiveNode, InputOutput>> ObjectiveNodes;
+		std::vector<Record<CommentNode>> Comments;
+		std::vector<Link> Links;
+	};
+
+	/**
+	* @brief Receives every Character once it's read, along with the offset the reader got to in the stream
+	*/
+	using CharacterCallback = std::function<void(std::unique_ptr<CharacterRecord> character, size_t offset)>;
+
+public:
+	SceneReader(CharacterCallback onCharacter);
+
+	/**
+	* @brief Reads the first document of the stream
+	* @details Throws a YAML::Exception if the YAML is malformed or a field is missing or mistyped
+	*/
+	void Read(std::istream& is);
+
+	void OnDocumentStart(const YAML::Mark&) override {}
+	void OnDocumentEnd(void) override {}
+
+	void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override;
+	void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override;
+	void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, const std::string& value) override;
+
+	void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override;
+	void OnSequenceEnd(void) override;
+
+	void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override;
+	void OnMapEnd(void) override;
+
+private:
+
+	/**
+	* @brief Nesting levels of the schema, a level is the number of collections that are open
+	*/
+	enum Level : size_t {
+		LEVEL_DOCUMENT = 0,
+		LEVEL_CHARACTERS,
+		LEVEL_CHARACTER,
+		LEVEL_SECTION,
+		LEVEL_NODE,
+		LEVEL_LIST,
+		LEVEL_ITEM,
+		LEVEL_CONDITION
+	};
+
+	enum Section : uint8_t {
+		SECTION_ENTRY = 0,
+		SECTION_VARIABLE,
+		SECTION_ACT,
+		SECTION_FORK,
+		SECTION_BRANCH,
+		SECTION_DIALOGUE,
+		SECTION_FLAVOR_MATCH,
+		SECTION_FLAVOR_CHECK,
+		SECTION_DICE,
+		SECTION_ACCEPT_QUEST,
+		SECTION_RETURN_QUEST,
+		SECTION_OBJECTIVE,
+		SECTION_COMMENT,
+		SECTION_LINK,
+		SECTION_COUNT,
+		SECTION_NAME = SECTION_COUNT//The Character's name, looked up with the sections since they share a map
+	};
+
+	enum Field : uint8_t {
+		FIELD_ID = 0,
+		FIELD_POSITION,
+		FIELD_TYPE,
+		FIELD_NAME,
+		FIELD_OPERATOR,
+		FIELD_VALUE,
+		FIELD_TITLE,
+		FIELD_DESCRIPTION,
+		FIELD_INPUT,
+		FIELD_OUTPUT,
+		FIELD_OUTPUTS,
+		FIELD_BUBBLES,
+		FIELD_EXPRESSIONS,
+		FIELD_PROMPTS,
+		FIELD_UUID,
+		FIELD_FOR_NPC,
+		FIELD_OBJECTIVES,
+		FIELD_QUEST_ID,
+		FIELD_OBJECTIVE_ID,
+		FIELD_SUCCEED,
+		FIELD_COMMENT,
+		FIELD_SIZE,
+		FIELD_START_PIN_ID,
+		FIELD_END_PIN_ID,
+		FIELD_SPEAKER,
+		FIELD_LINE,
+		FIELD_IS_OPTIONAL,
+		FIELD_COUNT
+	};
+
+	/**
+	* @brief Key that isn't part of the schema, its value is skipped
+	*/
+	static constexpr uint8_t KEY_NONE = 0xFF;
+
+	/**
+	* @brief Scalars of the map being read
+	*/
+	struct Fields {
+		std::array<std::string, FIELD_COUNT> Values;
+		uint32_t Present = 0;
+		YAML::Mark Mark;
+
+		void Reset(const YAML::Mark& mark) noexcept;
+		[[nodiscard]] bool Has(Field field) const noexcept { return Present & (1u << field); }
+
+		/**
+		* @brief Gets a field, throws if it's missing
+		*/
+		[[nodiscard]] const std::string& Get(Field field) const;
+		template<typename T>
+		[[nodiscard]] T As(Field field) const;
+	};
+
+	/**
+	* @brief Scalars of a list field, the strings keep their capacity from one node to the next
+	*/
+	struct List {
+		std::vector<std::string> Items;
+		size_t Count = 0;
+
+		[[nodiscard]] std::string& Add(void);
+		[[nodiscard]] const std::string& Get(size_t index, const YAML::Mark& mark) const;
+	};
+
+	/**
+	* @brief An open collection
+	*/
+	struct Frame {
+		bool IsMap = false;
+		bool AwaitingKey = true;
+		uint8_t Key = KEY_NONE;//Section at the Character level, Field below
+	};
+
+	/**
+	* @returns The Section or Field of a key, KEY_NONE if the level has no such key
+	*/
+	[[nodiscard]] static uint8_t FindKey(Level level, std::string_view key) noexcept;
+	[[nodiscard]] static const char* GetFieldKey(uint8_t field) noexcept;
+	[[nodiscard]] static bool IsListField(uint8_t field) noexcept;
+
+	[[nodiscard]] Level GetLevel(void) const noexcept { return static_cast<Level>(mFrames.size()); }
+	[[nodiscard]] uint8_t GetListField(void) const noexcept { return mFrames[LEVEL_NODE - 1].Key; }
+
+	/**
+	* @returns A bit for every Field the map being read uses
+	*/
+	[[nodiscard]] uint32_t GetUsedFields(void) const noexcept;
+	[[nodiscard]] List* FindList(uint8_t field) noexcept;
+
+	/**
+	* @returns False if the collection isn't part of the schema and is skipped
+	*/
+	[[nodiscard]] bool BeginCollection(const YAML::Mark& mark, bool isMap);
+	void EndCollection(bool isMap);
+	void ReadScalar(const YAML::Mark& mark, const std::string& value);
+	void EndValue(void) noexcept;
+
+	[[nodiscard]] ImVec2 GetVector(uint8_t field) const;
+	void FinishNode(void);
+	void FinishItem(uint8_t listField);
+	void FinishCondition(void);
+
+private:
+	CharacterCallback mOnCharacter;
+	std::vector<Frame> mFrames;
+	size_t mSkipping = 0;//Depth inside a collection that is skipped
+	size_t mOffset = 0;
+
+	std::unique_ptr<CharacterRecord> mCharacter;
+	YAML::Mark mCharacterMark;
+	bool mHasName = false;
+	uint8_t mSection = KEY_NONE;
+	Fields mNode;
+	Fields mItem;
+	List mPosition;
+	List mSize;
+	List mOutputs;
+	List mPrompts;
+	std::vector<std::pair<Speaker, std::string>> mBubbles;
+	std::vector<Expression> mExpressions;
+	std::vector<ObjectiveSpecification> mObjectives;
+};
@@ -1,21 +1,103 @@
 #pragma once
 
 #include "Scene.h"
+#include "Components.h"
+#include "Journal.h"
+#include "SceneReader.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
 
 //Forward Decleration(s)
 namespace YAML { class Emitter; }
 
 class SceneSerializer {
+public:
+
+	/**
+	* @brief Written by Load while it runs, so another thread can display how far it got
+	*/
+	struct LoadProgress {
+		std::atomic<size_t> BytesRead = 0;
+		std::atomic<size_t> FileSize = 0;
+		std::atomic<size_t> Built = 0;//Characters built so far
+	};
+
+	/**
+	* @brief A Character built by Load, with everything that needs the main thread kept aside
+	*/
+	struct LoadedCharacter {
+		Scene::CharacterData Data;
+		std::vector<std::pair<ed::NodeId, ImVec2>> Positions;
+		std::vector<std::pair<AcceptQuestNode, InputOutput>> Quests;
+
+		explicit LoadedCharacter(size_t characterID)
+			: Data(characterID) {}
+	};
+
+	/**
+	* @brief A project built by Load, ready to replace the content of a Scene with Apply
+	*/
+	struct LoadedScene {
+		std::deque<LoadedCharacter> Characters;//Stable references while the reader adds Characters
+		std::vector<Journal::Record> Replayed;//Journaled changes that aren't in the file yet, with the IDs Apply gives
+	};
+
 public:
 	SceneSerializer(Scene* scene);
 
-	void Serialize(const std::string& filepath);
-	void Deserialize(const std::string& filepath);
+	/**
+	* @brief Saves the Scene, the previous file is only replaced once the save is complete
+	* @returns True if the file was written
+	*/
+	bool Serialize(const std::string& filepath);
+	/**
+	* @returns The YAML of one Character, as the only element of a sequence
+	*/
+	[[nodiscard]] std::string SerializeCharacter(size_t index);
+	/**
+	* @brief Loads a Scene, positions are only restored if the Scene isn't headless
+	* @details Same as Apply(Load(filepath)), the Scene is left untouched if the file can't be loaded
+	* @returns False if the file couldn't be read or parsed
+	*/
+	bool Deserialize(const std::string& filepath, size_t threadCount = 0);
+
+	/**
+	* @brief Reads a project, each Character is built on a worker thread as soon as it's read
+	* @details Touches neither a Scene nor a node editor, so it can run on any thread while the
+	*	main thread keeps rendering
+	* @param threadCount Number of Characters built at once, 0 uses one per hardware thread
+	* @returns nullptr if the file couldn't be opened, throws a YAML::Exception if it can't be parsed
+	*/
+	[[nodiscard]] static std::unique_ptr<LoadedScene> Load(const std::string& filepath, LoadProgress* progress = nullptr, size_t threadCount = 0);
+
+	/**
+	* @brief Applies the journal of a project on top of it, for changes autosaved after the last full save
+	* @details Only the last version of each Character is built, the records that still matter are
+	*	kept in loaded.Replayed so the Scene can start its journal over from them
+	* @returns False if the project has no journal that matches it or the journal can't be applied,
+	*	the loaded project is left untouched then
+	*/
+	static bool Replay(const std::string& filepath, LoadedScene& loaded);
+
+	/**
+	* @brief Replaces the content of the Scene with a loaded project
+	* @details Must run on the thread owning the Scene: creates the node editors, adds the quests
+	*	and sets every node position in one batch per editor. Characters get their index as ID
+	*/
+	void Apply(LoadedScene& loaded);
 
 private:
 
 	//void SerializeEntity(YAML::Emitter& out, entt::entity entity);
+	void SerializeCharacter(YAML::Emitter& out, const Scene::CharacterData& characterData);
+
+	/**
+	* @brief Adds the nodes read by SceneReader to a Character, in the order entities were always created
+	*/
+	static void BuildCharacter(SceneReader::CharacterRecord& record, LoadedCharacter& loaded);
 
 private:
 	Scene* mScene = nullptr;
-};
\ No newline at end of file
+};
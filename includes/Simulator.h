@@ -0,0 +1,69 @@
+#pragma once
+
+#include "DialogueProgram.h"
+#include "StateMachine.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+* @brief Plays a compiled Character over and over with random choices, to see which parts of it get played
+* @details Dialogue choices, Dice outcomes and both Flavors are drawn at random for every playthrough.
+*	Playthroughs are split across worker threads, each with its own copy of the state machine, its
+*	own Random on a stream of the seed and its own counters. Nothing is shared until the workers are done and their
+*	reports are summed, so throughput grows with the number of cores.
+*/
+class Simulator {
+public:
+
+	struct Settings {
+		uint64_t Runs = 1'000'000;
+		uint32_t MaxSteps = 10'000;//Playthroughs still going after that many instructions are cut, so loops end
+		uint64_t Seed = 0;//Zero picks a random one, the same seed and thread count replay the same playthroughs
+		size_t ThreadCount = 0;//Zero picks one per hardware thread
+	};
+
+	/**
+	* @brief Shared with the workers while they run, to follow them from another thread
+	*/
+	struct Progress {
+		std::atomic<uint64_t> Done = 0;
+		std::atomic<bool> Cancelled = false;
+	};
+
+	struct Report {
+		uint64_t Runs = 0;
+		uint64_t Cut = 0;//Playthroughs stopped at MaxSteps
+		uint64_t Steps = 0;//Instructions executed by every playthrough together
+		uint32_t MinLength = 0;
+		uint32_t MaxLength = 0;
+		std::array<uint64_t, 33> Lengths = {};//Playthroughs by length, bucket i holds lengths in [2^(i-1), 2^i)
+
+		std::vector<uint64_t> Visits;//By instruction
+		std::vector<uint64_t> Ends;//By instruction, playthroughs that stopped on it
+		std::vector<uint64_t> Taken;//By output, laid out like the successors of DialogueProgram
+
+		[[nodiscard]] double GetMeanLength(void) const noexcept { return Runs == 0 ? 0.0 : static_cast<double>(Steps) / static_cast<double>(Runs); }
+		[[nodiscard]] uint64_t GetTaken(const DialogueProgram& program, uint32_t pc, uint32_t output) const { return Taken[program.GetInstruction(pc).FirstSuccessor + output]; }
+
+		void Merge(const Report& other);
+	};
+
+public:
+
+	/**
+	* @brief Plays settings.Runs playthroughs from the program's entry and blocks until they're done
+	* @param initial State every playthrough starts from, the program must have been compiled against it
+	* @param progress Optional, playthroughs already done are added to it and setting Cancelled stops early
+	*/
+	[[nodiscard]] static Report Run(const DialogueProgram& program, const StateMachine& initial, const Settings& settings, Progress* progress = nullptr);
+
+private:
+
+	/**
+	* @brief Playthroughs of one worker, into its own report
+	*/
+	static void Play(const DialogueProgram& program, const StateMachine& initial, uint64_t runs, uint32_t maxSteps, uint64_t seed, size_t worker, Report& report, Progress* progress);
+};
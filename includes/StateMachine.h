@@ -2,37 +2,88 @@
 
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 class StateMachine {
 public:
 
+	/**
+	* @brief Index of an interned variable name
+	* @details A slot can hold both a boolean and an integer value, mirroring
+	*	the separate boolean and integer namespaces variables live in.
+	*/
+	using Slot = uint32_t;
+
+	/**
+	* @brief Retrieves the slot of a variable name, creating it on first use
+	* @details Intended for setup time, every other call should use the returned slot
+	*/
+	[[nodiscard]] Slot Intern(const std::string& name);
+
+	template<typename T>
+	void SetValue(Slot slot, T val) { /*static_assert(false, "Not implemented yet!");*/ }
+
 	template<typename T>
-	void SetValue(const std::string& key, T val) { /*static_assert(false, "Not implemented yet!");*/ }
+	void SetValue(const std::string& key, T val) { SetValue<T>(Intern(key), val); }
 
-	void SetFork(const gte::uuid& key, bool val) { mForks.insert({ key, val }); }
+	/**
+	* @brief Retrieves the slot of a Fork node, creating it on first use
+	* @details Fork slots are separate from variable slots, they only store whether the fork was visited
+	*/
+	[[nodiscard]] Slot InternFork(const gte::uuid& fork);
 
+	void SetVisited(Slot fork, bool val) noexcept;
+	bool IsVisited(Slot fork) const noexcept { return mVisited[fork / 64] & (u64{ 1 } << (fork % 64)); }
 
-	bool Exists(const std::string& key) const noexcept { return mBooleans.find(key) != mBooleans.end(); }
-	int32_t GetIntValue(const std::string& key) { return mIntegers.find(key) != mIntegers.end() ? mIntegers.at(key) : 0; }
-	bool GetBoolValue(const std::string& key) { return Exists(key) ? mBooleans.at(key) : 0; }
+	bool Exists(Slot slot) const noexcept { return mFlags[slot] & HAS_BOOLEAN; }
+	bool IsInteger(Slot slot) const noexcept { return mFlags[slot] & HAS_INTEGER; }
+	int32_t GetIntValue(Slot slot) const noexcept { return mIntegers[slot]; }
+	bool GetBoolValue(Slot slot) const noexcept { return mBooleans[slot]; }
 
-	std::unordered_map<std::string, bool>& Booleans(void) noexcept { return mBooleans; }
-	std::unordered_map<gte::uuid, bool>& Forks(void) noexcept { return mForks; }
-	const std::unordered_map<std::string, bool>& Booleans(void) const noexcept { return mBooleans; }
-	const std::unordered_map<gte::uuid, bool>& Forks(void) const noexcept { return mForks; }
+	[[nodiscard]] const std::string& GetName(Slot slot) const { return mNames[slot]; }
+	[[nodiscard]] size_t Size(void) const noexcept { return mNames.size(); }
 
+	[[nodiscard]] const gte::uuid& GetFork(Slot fork) const { return mForkIDs[fork]; }
+	[[nodiscard]] size_t ForkCount(void) const noexcept { return mForkIDs.size(); }
 
-	std::unordered_map<std::string, int32_t>& Integers(void) noexcept { return mIntegers; }
-	const std::unordered_map<std::string, int32_t>& Integers(void) const noexcept { return mIntegers; }
+	/**
+	* @brief Forgets every boolean and integer value and which forks were visited
+	* @details Interned names are kept so slots handed out before stay valid
+	*/
+	void Clear(void);
 
-	void Clear(void) { mBooleans.clear(); mIntegers.clear(); }
+	/**
+	* @brief Copies every value and visited fork of a state machine that has the same slots
+	* @details Meant to restart from a prepared state over and over, nothing is reallocated
+	*/
+	void Restore(const StateMachine& snapshot) noexcept;
+
+	/**
+	* @brief Appends every value and visited fork as raw bytes
+	* @details State machines with the same slots hold the same values exactly when their bytes are equal
+	*/
+	void Pack(std::string& out) const;
+	/**
+	* @brief Reads bytes written by Pack, from a state machine with the same slots
+	*/
+	void Unpack(const char* data) noexcept;
 
 private:
 
-	std::unordered_map<std::string, bool> mBooleans;
-	std::unordered_map<gte::uuid, bool> mForks;
-	std::unordered_map<std::string, int32_t> mIntegers;
+	static constexpr uint8_t HAS_BOOLEAN = 1 << 0;
+	static constexpr uint8_t HAS_INTEGER = 1 << 1;
+
+	std::unordered_map<std::string, Slot> mSymbols;
+	std::vector<std::string> mNames;
+	std::vector<uint8_t> mFlags;
+	std::vector<uint8_t> mBooleans;
+	std::vector<int32_t> mIntegers;
+
+	std::unordered_map<gte::uuid, Slot> mForks;
+	std::vector<gte::uuid> mForkIDs;
+	std::vector<u64> mVisited;
 
 };
 
-#include "StateMachine.hpp"
\ No newline at end of file
+#include "StateMachine.hpp"
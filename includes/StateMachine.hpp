@@ -2,11 +2,87 @@
 
 #include "StateMachine.h"
 
+#include <algorithm>
+#include <cstring>
+
 template<>
-inline void StateMachine::SetValue<bool>(const std::string& key, bool val) { mBooleans[key] = val; }
+inline void StateMachine::SetValue<bool>(Slot slot, bool val) { mBooleans[slot] = val; mFlags[slot] |= HAS_BOOLEAN; }
 
 template<>
-inline void StateMachine::SetValue<int>(const std::string& key, int32_t val) { mIntegers[key] = val; }
+inline void StateMachine::SetValue<int>(Slot slot, int32_t val) { mIntegers[slot] = val; mFlags[slot] |= HAS_INTEGER; }
+
+[[nodiscard]] inline StateMachine::Slot StateMachine::Intern(const std::string& name)
+{
+	auto [it, inserted] = mSymbols.try_emplace(name, static_cast<Slot>(mNames.size()));
+	if (inserted)
+	{
+		mNames.emplace_back(name);
+		mFlags.emplace_back(0);
+		mBooleans.emplace_back(0);
+		mIntegers.emplace_back(0);
+	}
+	return it->second;
+}
+
+[[nodiscard]] inline StateMachine::Slot StateMachine::InternFork(const gte::uuid& fork)
+{
+	auto [it, inserted] = mForks.try_emplace(fork, static_cast<Slot>(mForkIDs.size()));
+	if (inserted)
+	{
+		mForkIDs.emplace_back(fork);
+		if (mForkIDs.size() > mVisited.size() * 64)
+			mVisited.emplace_back(0);
+	}
+	return it->second;
+}
+
+inline void StateMachine::SetVisited(Slot fork, bool val) noexcept
+{
+	const u64 mask = u64{ 1 } << (fork % 64);
+	if (val)
+		mVisited[fork / 64] |= mask;
+	else
+		mVisited[fork / 64] &= ~mask;
+}
+
+inline void StateMachine::Clear(void)
+{
+	std::fill(mFlags.begin(), mFlags.end(), 0);
+	std::fill(mBooleans.begin(), mBooleans.end(), 0);
+	std::fill(mIntegers.begin(), mIntegers.end(), 0);
+	std::fill(mVisited.begin(), mVisited.end(), 0);
+}
+
+inline void StateMachine::Restore(const StateMachine& snapshot) noexcept
+{
+	std::copy(snapshot.mFlags.begin(), snapshot.mFlags.end(), mFlags.begin());
+	std::copy(snapshot.mBooleans.begin(), snapshot.mBooleans.end(), mBooleans.begin());
+	std::copy(snapshot.mIntegers.begin(), snapshot.mIntegers.end(), mIntegers.begin());
+	std::copy(snapshot.mVisited.begin(), snapshot.mVisited.end(), mVisited.begin());
+}
+
+inline void StateMachine::Pack(std::string& out) const
+{
+	out.append(reinterpret_cast<const char*>(mFlags.data()), mFlags.size());
+	out.append(reinterpret_cast<const char*>(mBooleans.data()), mBooleans.size());
+	out.append(reinterpret_cast<const char*>(mIntegers.data()), mIntegers.size() * sizeof(int32_t));
+	out.append(reinterpret_cast<const char*>(mVisited.data()), mVisited.size() * sizeof(u64));
+}
+
+inline void StateMachine::Unpack(const char* data) noexcept
+{
+	// memcpy can't be handed the null data() of an empty vector, even for zero bytes
+	auto read = [&data](auto& values) {
+		const size_t size = values.size() * sizeof(values[0]);
+		if (size > 0)
+			std::memcpy(values.data(), data, size);
+		data += size;
+	};
+	read(mFlags);
+	read(mBooleans);
+	read(mIntegers);
+	read(mVisited);
+}
 
 //template<typename T>
 //inline T StateMachine::GetValue(const std::string key)
@@ -15,4 +91,4 @@ inline void StateMachine::SetValue<int>(const std::string& key, int32_t val) { m
 //		return mBooleans.find(key) != mBooleans.end() ? mBooleans.at(key) : 0;
 //	else
 //		return mIntegers.find(key) != mIntegers.end() ? mIntegers.at(key) : 0;
-//}
\ No newline at end of file
+//}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+* @brief Fixed set of worker threads running submitted tasks in FIFO order
+* @details Every task runs on one worker from start to finish, so thread_local state
+*	(like Character::sQuestECS) stays consistent within a task.
+*/
+class ThreadPool {
+public:
+
+	/**
+	* @param threadCount Number of workers, zero picks one per hardware thread
+	*/
+	ThreadPool(size_t threadCount = 0);
+	~ThreadPool(void) noexcept;
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	* @brief Queues a task
+	* @returns A future holding the task's result, or the exception it threw
+	*/
+	template<typename Fn>
+	[[nodiscard]] std::future<std::invoke_result_t<Fn>> Submit(Fn&& fn);
+
+	[[nodiscard]] size_t Size(void) const noexcept { return mWorkers.size(); }
+
+private:
+
+	void Work(void);
+
+private:
+	std::vector<std::thread> mWorkers;
+	std::queue<std::function<void()>> mTasks;
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	bool mStopping = false;
+};
+
+#include <ThreadPool.hpp>
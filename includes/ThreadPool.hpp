@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ThreadPool.h>
+#include <memory>
+
+template<typename Fn>
+[[nodiscard]] inline std::future<std::invoke_result_t<Fn>> ThreadPool::Submit(Fn&& fn)
+{
+	// std::function needs a copyable target, so the task is shared
+	auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Fn>()>>(std::forward<Fn>(fn));
+	auto future = task->get_future();
+	{
+		std::lock_guard lock(mMutex);
+		mTasks.emplace([task]() { (*task)(); });
+	}
+	mCondition.notify_one();
+	return future;
+}
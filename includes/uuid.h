@@ -11,6 +11,7 @@
 #endif
 
 #include <cstdint>
+#include <cstring>
 // Green-Tea engine definitions **needed for uuid**
 // TODO: Define proper functionality 
 #define ASSERT(...) 
@@ -177,7 +178,19 @@ namespace std {
 
 	template<>
 	struct hash<gte::uuid> {
-		[[nodiscard]] size_t operator()(const gte::uuid& id) const;
+		/// @brief Hashes the raw 128 bits of the identifier, without formatting it as a string
+		[[nodiscard]] size_t operator()(const gte::uuid& id) const noexcept
+		{
+			static_assert(sizeof(id.mUUID) == 2 * sizeof(u64), "uuid is expected to be 128 bits");
+			u64 words[2];
+			std::memcpy(words, &id.mUUID, sizeof(words));
+
+			// splitmix64 finalizer over both halves, so every input byte affects every output bit
+			u64 h = words[0] ^ (words[1] * 0x9E3779B97F4A7C15ull);
+			h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+			h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+			return static_cast<size_t>(h ^ (h >> 31));
+		}
 	};
 
 }
@@ -125,6 +125,137 @@ project "PuruPuru"
     filter "configurations:Debug"
         runtime "Debug"
         symbols "on"
+        defines "PURU_DEBUG"
     filter "configurations:Release"
 		runtime "Release"
-		optimize "on"
\ No newline at end of file
+		optimize "on"
+
+project "purupuru-cli"
+    kind "ConsoleApp"
+    language "C++"
+	cppdialect "C++20"
+
+    targetdir("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+    -- Same model, serializers and exporters as the editor, without a window, renderer or file dialogs
+    files
+    {
+        "cli/**.cpp",
+        "src/**.h",
+        "src/**.hpp",
+        "src/**.cpp",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source/*.h",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source/ax/*.h",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source/ax/*.cpp",
+    }
+
+    removefiles
+    {
+        "src/main.cpp",
+        "src/*FileDialog.cpp",
+    }
+
+    includedirs
+    {
+        "includes",
+        "%{IncludeDirs.yaml}",
+        "%{IncludeDirs.entt}",
+        "%{IncludeDirs.imgui}",
+        "%{IncludeDirs.imnodes}/NodeEditor/Include",
+        "%{IncludeDirs.imnodes}/ThirdParty/ScopeGuard",
+        "%{IncludeDirs.imnodes}/Examples/Common/Application/Include",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Include",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source",
+    }
+
+    links { "ImGui", "imgui-node-editor", "yaml-cpp", }
+
+    defines { "IMGUI_DEFINE_MATH_OPERATORS", "NOMINMAX", "_CRT_SECURE_NO_WARNINGS" }
+
+    filter "system:windows"
+		systemversion "latest"
+
+        disablewarnings {4311, 4267, 4302}
+
+        defines "PLATFORM_WINDOWS"
+
+    filter "system:linux"
+        systemversion "latest"
+        pic "On"
+
+        links { "uuid", "pthread", }
+
+    filter "configurations:Debug"
+        runtime "Debug"
+        symbols "on"
+        defines "PURU_DEBUG"
+    filter "configurations:Release"
+		runtime "Release"
+		optimize "on"
+
+project "purupuru-bench"
+    kind "ConsoleApp"
+    language "C++"
+	cppdialect "C++20"
+
+    targetdir("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+    -- Microbenchmarks of the editor's and runtime's hot paths, built like purupuru-cli
+    files
+    {
+        "bench/**.cpp",
+        "cli/Headless.cpp",
+        "src/**.h",
+        "src/**.hpp",
+        "src/**.cpp",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source/*.h",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source/ax/*.h",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source/ax/*.cpp",
+    }
+
+    removefiles
+    {
+        "src/main.cpp",
+        "src/*FileDialog.cpp",
+    }
+
+    includedirs
+    {
+        "includes",
+        "%{IncludeDirs.yaml}",
+        "%{IncludeDirs.entt}",
+        "%{IncludeDirs.imgui}",
+        "%{IncludeDirs.imnodes}/NodeEditor/Include",
+        "%{IncludeDirs.imnodes}/NodeEditor/Source",
+        "%{IncludeDirs.imnodes}/ThirdParty/ScopeGuard",
+        "%{IncludeDirs.imnodes}/Examples/Common/Application/Include",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Include",
+        "%{IncludeDirs.imnodes}/Examples/Common/BlueprintUtilities/Source",
+    }
+
+    links { "ImGui", "imgui-node-editor", "yaml-cpp", }
+
+    defines { "IMGUI_DEFINE_MATH_OPERATORS", "NOMINMAX", "_CRT_SECURE_NO_WARNINGS" }
+
+    filter "system:windows"
+		systemversion "latest"
+
+        disablewarnings {4311, 4267, 4302}
+
+        defines "PLATFORM_WINDOWS"
+
+    filter "system:linux"
+        systemversion "latest"
+        pic "On"
+
+        links { "uuid", "pthread", }
+
+    filter "configurations:Debug"
+        runtime "Debug"
+        symbols "on"
+        defines "PURU_DEBUG"
+    filter "configurations:Release"
+		runtime "Release"
+		optimize "on"
@@ -0,0 +1,79 @@
+#include <Actions.h>
+#include <Character.h>
+
+ed::NodeId NodeSnapshot::GetID(void) const noexcept
+{
+	return std::visit([](const Node& node) { return node.ID; }, Self);
+}
+
+size_t NodeSnapshot::GetSize(void) const noexcept
+{
+	size_t size = sizeof(*this);
+	std::visit([&size](const auto& node) {
+		using T = std::decay_t<decltype(node)>;
+		size += node.State.capacity() + node.SavedState.capacity();
+		if constexpr (std::is_same_v<T, ActNode>)
+			for (const auto& [speaker, line] : node.Bubbles)
+				size += sizeof(speaker) + sizeof(line) + line.capacity();
+		else if constexpr (std::is_same_v<T, BranchNode>)
+			for (const auto& expression : node.Expressions)
+				size += sizeof(expression) + expression.capacity() * sizeof(Condition);
+		else if constexpr (std::is_same_v<T, DialogueNode>)
+			for (const auto& prompt : node.Prompts)
+				size += sizeof(prompt) + prompt.capacity();
+		else if constexpr (std::is_same_v<T, AcceptQuestNode>)
+			size += node.Objectives.capacity() * sizeof(ObjectiveSpecification);
+		else if constexpr (std::is_same_v<T, CommentNode>)
+			size += node.Comment.capacity();
+	}, Self);
+	if (const auto* pins = std::get_if<InputOutputs>(&Pins))
+		size += pins->Outputs.capacity() * sizeof(Pin);
+	return size;
+}
+
+void GroupAction::MoveForward(Character& character)
+{
+	for (auto& action : mActions)
+		action->MoveForward(character);
+}
+
+void GroupAction::MoveBack(Character& character)
+{
+	for (auto it = mActions.rbegin(); it != mActions.rend(); ++it)
+		(*it)->MoveBack(character);
+}
+
+size_t GroupAction::GetSize(void) const noexcept
+{
+	size_t size = sizeof(*this) + mActions.capacity() * sizeof(std::unique_ptr<IAction>);
+	for (const auto& action : mActions)
+		size += action->GetSize();
+	return size;
+}
+
+void SpawnNodeAction::MoveForward(Character& character) { character.RestoreNode(mNode, true); }
+void SpawnNodeAction::MoveBack(Character& character) { character.RemoveNode(mNode.GetID()); }
+
+void DeleteNodeAction::MoveForward(Character& character) { character.RemoveNode(mNode.GetID()); }
+void DeleteNodeAction::MoveBack(Character& character) { character.RestoreNode(mNode, true); }
+
+void EditNodeAction::MoveForward(Character& character) { character.RestoreNode(mAfter, false); }
+void EditNodeAction::MoveBack(Character& character) { character.RestoreNode(mBefore, false); }
+
+void CreateLinkAction::MoveForward(Character& character) { character.RestoreLink(mLink); }
+void CreateLinkAction::MoveBack(Character& character) { character.RemoveLink(mLink.ID); }
+
+void DeleteLinkAction::MoveForward(Character& character) { character.RemoveLink(mLink.ID); }
+void DeleteLinkAction::MoveBack(Character& character) { character.RestoreLink(mLink); }
+
+void MoveNodesAction::MoveForward(Character&)
+{
+	for (const auto& move : mMoves)
+		ed::SetNodePosition(move.ID, move.To);
+}
+
+void MoveNodesAction::MoveBack(Character&)
+{
+	for (const auto& move : mMoves)
+		ed::SetNodePosition(move.ID, move.From);
+}
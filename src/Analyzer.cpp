@@ -0,0 +1,292 @@
+#include <Analyzer.h>
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+// Rough cost of a state besides its bytes, for its node in the seen set and its copy in the queue
+static constexpr size_t STATE_OVERHEAD = 64;
+static constexpr size_t SHARD_COUNT = 64;
+
+// Flavors a Character can be given in the editor, combinations never come out of a FlavorCheck
+static constexpr int32_t FLAVOR_COUNT = static_cast<int32_t>(Flavor::Neutral) + 1;
+
+// A state is the instruction, both Flavors and then the bytes of the state machine
+static constexpr size_t HEADER_SIZE = sizeof(uint32_t) + 2;
+
+static void Encode(std::string& key, uint32_t pc, std::pair<Flavor, Flavor> flavors, const StateMachine& state)
+{
+	key.clear();
+	key.append(reinterpret_cast<const char*>(&pc), sizeof(pc));
+	key.push_back(static_cast<char>(flavors.first));
+	key.push_back(static_cast<char>(flavors.second));
+	state.Pack(key);
+}
+
+static uint32_t Decode(const std::string& key, std::pair<Flavor, Flavor>& flavors, StateMachine& state)
+{
+	uint32_t pc;
+	std::memcpy(&pc, key.data(), sizeof(pc));
+	flavors = { static_cast<Flavor>(key[sizeof(pc)]), static_cast<Flavor>(key[sizeof(pc) + 1]) };
+	state.Unpack(key.data() + HEADER_SIZE);
+	return pc;
+}
+
+/**
+* @brief States stretches start from, shared by the workers
+* @details The seen set is split in shards so workers rarely wait on each other
+*/
+struct Exploration {
+	struct Shard {
+		std::mutex Mutex;
+		std::unordered_set<std::string> Seen;
+	};
+
+	std::array<Shard, SHARD_COUNT> Shards;
+	std::atomic<size_t> Memory = 0;
+	std::atomic<bool> Exhausted = false;
+	size_t MemoryLimit = 0;
+
+	std::mutex QueueMutex;
+	std::condition_variable QueueCondition;
+	std::vector<std::string> Queue;
+	size_t Busy = 0;//Workers in the middle of a stretch, they can still queue more
+
+	/**
+	* @brief Queues a state unless it was seen before or the memory cap is reached
+	*/
+	void Push(const std::string& key)
+	{
+		auto& shard = Shards[std::hash<std::string>{}(key) % SHARD_COUNT];
+		{
+			std::lock_guard lock(shard.Mutex);
+			if (shard.Seen.contains(key))
+				return;
+
+			// Reserved in one step, other shards could push past the cap between a check and an add
+			const size_t cost = 2 * key.size() + STATE_OVERHEAD;
+			if (Memory.fetch_add(cost) + cost > MemoryLimit)
+			{
+				Memory -= cost;
+				Exhausted = true;
+				return;
+			}
+			shard.Seen.insert(key);
+		}
+
+		{
+			std::lock_guard lock(QueueMutex);
+			Queue.push_back(key);
+		}
+		QueueCondition.notify_one();
+	}
+
+	/**
+	* @brief Takes the next state to explore, waiting while other workers might still queue some
+	* @returns False once every state is explored
+	*/
+	bool Pop(std::string& key)
+	{
+		std::unique_lock lock(QueueMutex);
+		QueueCondition.wait(lock, [this]() { return !Queue.empty() || Busy == 0; });
+		if (Queue.empty())
+			return false;
+		key = std::move(Queue.back());
+		Queue.pop_back();
+		Busy++;
+		return true;
+	}
+
+	void Finish(void)
+	{
+		{
+			std::lock_guard lock(QueueMutex);
+			Busy--;
+		}
+		QueueCondition.notify_all();
+	}
+
+	/**
+	* @brief Finishes a popped state however its stretch ends, a worker that throws mustn't leave the others waiting
+	*/
+	struct Popped {
+		Exploration& Self;
+		~Popped(void) { Self.Finish(); }
+	};
+};
+
+/**
+* @brief What one worker found, merged into the report once every worker is done
+*/
+struct Findings {
+	uint64_t Stretches = 0;
+	std::vector<uint8_t> Reached;
+	std::vector<uint8_t> Taken;
+	std::set<std::vector<uint32_t>> Loops;
+	std::set<uint32_t> Runaways;
+	std::set<uint32_t> DivisionsByZero;
+};
+
+static void Explore(const DialogueProgram& program, const StateMachine& initial, const Analyzer::Settings& settings, Exploration& exploration, Findings& findings)
+{
+	StateMachine state = initial;
+	std::pair<Flavor, Flavor> flavors;
+	std::string start, key, saved;
+	Random random;//Never drawn from, Dice are expanded instead of rolled
+
+	while (exploration.Pop(start))
+	{
+		const Exploration::Popped popped{ exploration };
+		findings.Stretches++;
+		uint32_t pc = Decode(start, flavors, state);
+
+		// Brent's cycle detection, only the state saved at the last power of two is kept whatever the stretch's length
+		uint32_t steps = 0;
+		uint32_t savedAt = 0;
+		uint32_t power = 1;
+		bool acted = false;
+		while (true)
+		{
+			const auto& instruction = program.GetInstruction(pc);
+			findings.Reached[pc] = 1;
+
+			// Every output of a Dialogue or Dice starts a stretch of its own, neither changes the state
+			if (instruction.Op == NodeType::Dialogue || instruction.Op == NodeType::Dice)
+			{
+				const auto successors = program.GetSuccessors(pc);
+				for (uint32_t output = 0; output < successors.size(); output++)
+				{
+					findings.Taken[instruction.FirstSuccessor + output] = 1;
+					if (successors[output] == DialogueProgram::END)
+						continue;
+					Encode(key, successors[output], flavors, state);
+					exploration.Push(key);
+				}
+				break;
+			}
+
+			// The runtime leaves the variable alone, games built on the export may not
+			if (instruction.Op == NodeType::IntVariable && instruction.Operator == SetOperator::Divide && instruction.Value == 0)
+				findings.DivisionsByZero.insert(pc);
+
+			// The same state came back without the player or the dice having a say, so it comes back forever
+			Encode(key, pc, flavors, state);
+			if (steps > 0 && key == saved)
+			{
+				// Going around once more from here gives the loop's instructions
+				std::vector<uint32_t> loop;
+				loop.reserve(steps - savedAt);
+				for (uint32_t step = savedAt; step < steps; step++)
+				{
+					loop.push_back(pc);
+					pc = program.GetSuccessors(pc)[program.Execute(pc, state, flavors, random)];
+				}
+				if (std::none_of(loop.begin(), loop.end(), [&program](uint32_t step) { return program.GetOpCode(step) == NodeType::Act; }))
+				{
+					std::sort(loop.begin(), loop.end());
+					loop.erase(std::unique(loop.begin(), loop.end()), loop.end());
+					findings.Loops.insert(std::move(loop));
+				}
+				break;
+			}
+			// Like a loop, a stretch that keeps playing Acts gives the player something to watch
+			if (steps == settings.MaxStretch)
+			{
+				if (!acted)
+					findings.Runaways.insert(pc);
+				break;
+			}
+			if (steps - savedAt == power || steps == 0)
+			{
+				saved = key;
+				savedAt = steps;
+				power = steps == 0 ? 1 : power * 2;
+			}
+			steps++;
+			acted |= instruction.Op == NodeType::Act;
+
+			const uint32_t output = program.Execute(pc, state, flavors, random);
+			if (output >= instruction.SuccessorCount)
+				break;
+			findings.Taken[instruction.FirstSuccessor + output] = 1;
+			pc = program.GetSuccessors(pc)[output];
+			if (pc == DialogueProgram::END)
+				break;
+		}
+	}
+}
+
+[[nodiscard]] Analyzer::Report Analyzer::Run(const DialogueProgram& program, const StateMachine& initial, const Settings& settings)
+{
+	Report report;
+	report.Reached.assign(program.Size(), 0);
+	if (program.Size() > 0)
+	{
+		const auto& last = program.GetInstruction(static_cast<uint32_t>(program.Size() - 1));
+		report.Taken.assign(last.FirstSuccessor + last.SuccessorCount, 0);
+	}
+	if (program.GetEntry() == DialogueProgram::END)
+		return report;
+
+	auto exploration = std::make_unique<Exploration>();
+	exploration->MemoryLimit = settings.MemoryLimit;
+
+	// Flavors only make a difference to programs that check them
+	bool flavored = false;
+	for (uint32_t pc = 0; pc < program.Size(); pc++)
+		flavored |= program.GetOpCode(pc) == NodeType::FlavorMatch || program.GetOpCode(pc) == NodeType::FlavorCheck;
+
+	std::string key;
+	const int32_t flavorCount = flavored ? FLAVOR_COUNT : 1;
+	for (int32_t main = 0; main < flavorCount; main++)
+	{
+		for (int32_t npc = 0; npc < flavorCount; npc++)
+		{
+			const auto flavors = flavored ? std::make_pair(static_cast<Flavor>(main), static_cast<Flavor>(npc)) : std::make_pair(Flavor::Neutral, Flavor::Neutral);
+			Encode(key, program.GetEntry(), flavors, initial);
+			exploration->Push(key);
+		}
+	}
+
+	const size_t threadCount = settings.ThreadCount == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : settings.ThreadCount;
+	Findings empty;
+	empty.Reached = report.Reached;
+	empty.Taken = report.Taken;
+	std::vector<Findings> findings(threadCount, empty);
+	{
+		ThreadPool pool(threadCount);
+		std::vector<std::future<void>> pending;
+		pending.reserve(threadCount);
+		for (size_t worker = 0; worker < threadCount; worker++)
+			pending.emplace_back(pool.Submit([&, worker]() { Explore(program, initial, settings, *exploration, findings[worker]); }));
+		for (auto& future : pending)
+			future.get();
+	}
+
+	std::set<std::vector<uint32_t>> loops;
+	std::set<uint32_t> runaways, divisionsByZero;
+	for (auto& found : findings)
+	{
+		report.Stretches += found.Stretches;
+		for (size_t pc = 0; pc < report.Reached.size(); pc++)
+			report.Reached[pc] |= found.Reached[pc];
+		for (size_t output = 0; output < report.Taken.size(); output++)
+			report.Taken[output] |= found.Taken[output];
+		loops.merge(found.Loops);
+		runaways.merge(found.Runaways);
+		divisionsByZero.merge(found.DivisionsByZero);
+	}
+	report.Loops.assign(loops.begin(), loops.end());
+	report.Runaways.assign(runaways.begin(), runaways.end());
+	report.DivisionsByZero.assign(divisionsByZero.begin(), divisionsByZero.end());
+	report.Complete = !exploration->Exhausted;
+	return report;
+}
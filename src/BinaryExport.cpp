@@ -0,0 +1,484 @@
+#include <BinaryExport.h>
+
+#include <yaml-cpp/yaml.h>
+#include <cstring>
+
+static std::string SerializeSetOperator(SetOperator pOperator);
+static std::string SerializeCompareOperator(CompareOperator pOperator);
+static std::string SerializeSpeaker(Speaker pSpeaker);
+
+BinaryExport::BinaryExport(const void* data, size_t size) noexcept
+	: mData(static_cast<const uint8_t*>(data)), mSize(size) {}
+
+[[nodiscard]] const BinaryExport::Section* BinaryExport::FindSection(SectionType type) const noexcept
+{
+	if (!mData || mSize < sizeof(Header))
+		return nullptr;
+
+	const auto* header = reinterpret_cast<const Header*>(mData);
+	if ((uint64_t)header->SectionCount * sizeof(Section) > mSize - sizeof(Header))
+		return nullptr;
+
+	const auto* sections = reinterpret_cast<const Section*>(mData + sizeof(Header));
+	for (uint32_t i = 0; i < header->SectionCount; i++)
+		if (sections[i].Type == type)
+			return &sections[i];
+	return nullptr;
+}
+
+[[nodiscard]] std::string_view BinaryExport::GetString(StringRef ref) const noexcept
+{
+	const Section* section = FindSection(SectionType::Strings);
+	if (!section)
+		return {};
+	return { reinterpret_cast<const char*>(mData + section->Offset + ref.Offset), ref.Length };
+}
+
+[[nodiscard]] std::span<const uint32_t> BinaryExport::GetTargets(const NodeRecord& node, uint32_t output) const noexcept
+{
+	if (output >= node.OutputCount)
+		return {};
+	const auto& range = GetOutputs()[node.FirstOutput + output];
+	return GetTargets().subspan(range.FirstTarget, range.TargetCount);
+}
+
+template<typename T>
+[[nodiscard]] const char* BinaryExport::ValidateSection(SectionType type) const noexcept
+{
+	const Section* section = FindSection(type);
+	if (!section)
+		return nullptr;//Missing sections are read as empty
+	if (section->Offset % ALIGNMENT != 0)
+		return "Section is not aligned";
+	if (section->Offset > mSize || section->Size > mSize - section->Offset)
+		return "Section is out of the file's bounds";
+	if ((uint64_t)section->Count * sizeof(T) != section->Size)
+		return "Section size doesn't match its record count";
+	return nullptr;
+}
+
+[[nodiscard]] const char* BinaryExport::Validate(void) const noexcept
+{
+	if (!mData || mSize < sizeof(Header))
+		return "File is too small to be a binary export";
+
+	const auto* header = reinterpret_cast<const Header*>(mData);
+	if (std::memcmp(header->Magic, MAGIC, sizeof(MAGIC)) != 0)
+		return "File is not a binary export";
+	if (header->VersionMajor != VERSION_MAJOR)
+		return "Unsupported binary export version";
+	if (header->FileSize != mSize)
+		return "File size doesn't match the header";
+	if ((uint64_t)header->SectionCount * sizeof(Section) > mSize - sizeof(Header))
+		return "Section table is out of the file's bounds";
+
+	const auto* sections = reinterpret_cast<const Section*>(mData + sizeof(Header));
+	for (uint32_t i = 0; i < header->SectionCount; i++)
+	{
+		if (sections[i].Type >= SectionType::Count)
+			return "Unknown section";
+		for (uint32_t j = 0; j < i; j++)
+			if (sections[j].Type == sections[i].Type)
+				return "Duplicate section";
+	}
+
+	const char* error = nullptr;
+	if ((error = ValidateSection<CharacterRecord>(SectionType::Characters)))	return error;
+	if ((error = ValidateSection<NodeRecord>(SectionType::Nodes)))				return error;
+	if ((error = ValidateSection<Output>(SectionType::Outputs)))				return error;
+	if ((error = ValidateSection<uint32_t>(SectionType::Targets)))				return error;
+	if ((error = ValidateSection<Bubble>(SectionType::Bubbles)))				return error;
+	if ((error = ValidateSection<StringRef>(SectionType::Prompts)))				return error;
+	if ((error = ValidateSection<Expression>(SectionType::Expressions)))		return error;
+	if ((error = ValidateSection<Condition>(SectionType::Conditions)))			return error;
+	if ((error = ValidateSection<Objective>(SectionType::Objectives)))			return error;
+	if ((error = ValidateSection<char>(SectionType::Strings)))					return error;
+
+	const auto strings = GetSection<char>(SectionType::Strings);
+	auto isValidString = [&strings](StringRef ref) {
+		return (uint64_t)ref.Offset + ref.Length < strings.size() && strings[ref.Offset + ref.Length] == '\0';
+	};
+	auto isValidRange = [](uint32_t first, uint32_t count, size_t size) {
+		return (uint64_t)first + count <= size;
+	};
+
+	const auto nodes = GetNodes();
+	const auto outputs = GetOutputs();
+	const auto targets = GetTargets();
+	const auto bubbles = GetBubbles();
+	const auto prompts = GetPrompts();
+	const auto expressions = GetExpressions();
+	const auto conditions = GetConditions();
+	const auto objectives = GetObjectives();
+
+	for (const auto& character : GetCharacters())
+	{
+		if (!isValidString(character.Name))
+			return "Character name is out of the string blob";
+		if (!isValidRange(character.FirstNode, character.NodeCount, nodes.size()))
+			return "Character nodes are out of bounds";
+		if (character.Entry != NONE && character.Entry >= nodes.size())
+			return "Character entry is out of bounds";
+	}
+
+	for (const auto& node : nodes)
+	{
+		if (node.Type <= static_cast<uint16_t>(NodeType::None) || node.Type > static_cast<uint16_t>(NodeType::Objective))
+			return "Unknown node type";
+		if (!isValidRange(node.FirstOutput, node.OutputCount, outputs.size()))
+			return "Node outputs are out of bounds";
+		if (!isValidString(node.Text) || !isValidString(node.Description))
+			return "Node text is out of the string blob";
+
+		size_t operands = 0;
+		switch (static_cast<NodeType>(node.Type))
+		{
+		case NodeType::Act:				operands = bubbles.size();		break;
+		case NodeType::Dialogue:		operands = prompts.size();		break;
+		case NodeType::Branch:			operands = expressions.size();	break;
+		case NodeType::AcceptQuest:		operands = objectives.size();	break;
+		default:														break;
+		}
+		if (!isValidRange(node.FirstOperand, node.OperandCount, operands))
+			return "Node operands are out of bounds";
+	}
+
+	for (const auto& output : outputs)
+		if (!isValidRange(output.FirstTarget, output.TargetCount, targets.size()))
+			return "Output targets are out of bounds";
+	for (const auto target : targets)
+		if (target >= nodes.size())
+			return "Target is out of bounds";
+
+	for (const auto& bubble : bubbles)
+		if (!isValidString(bubble.Line))
+			return "Bubble line is out of the string blob";
+	for (const auto& prompt : prompts)
+		if (!isValidString(prompt))
+			return "Prompt is out of the string blob";
+	for (const auto& expression : expressions)
+		if (!isValidRange(expression.FirstCondition, expression.ConditionCount, conditions.size()))
+			return "Expression conditions are out of bounds";
+	for (const auto& condition : conditions)
+		if (!isValidString(condition.Name))
+			return "Condition name is out of the string blob";
+	for (const auto& objective : objectives)
+		if (!isValidString(objective.Title) || !isValidString(objective.Description))
+			return "Objective text is out of the string blob";
+
+	return nullptr;
+}
+
+void BinaryExport::DumpYAML(YAML::Emitter& out) const
+{
+	const auto nodes = GetNodes();
+	auto str = [this](StringRef ref) { return std::string(GetString(ref)); };
+	auto emitTargets = [this, &out, &nodes](const NodeRecord& node, uint32_t output) {
+		const auto targets = GetTargets(node, output);
+		out << YAML::BeginSeq;
+		if (targets.empty())
+			out << 0;
+		for (const auto target : targets)
+			out << (int64_t)nodes[target].ID;
+		out << YAML::EndSeq;
+	};
+	auto emitAllTargets = [&out, &emitTargets](const NodeRecord& node) {
+		out << YAML::BeginSeq;
+		for (uint32_t i = 0; i < node.OutputCount; i++)
+			emitTargets(node, i);
+		out << YAML::EndSeq;
+	};
+
+	out << YAML::BeginMap;
+	out << YAML::Key << "Characters" << YAML::Value;
+	out << YAML::BeginSeq;
+	for (const auto& character : GetCharacters())
+	{
+		const auto characterNodes = nodes.subspan(character.FirstNode, character.NodeCount);
+		auto each = [&characterNodes](std::initializer_list<NodeType> types, auto&& fn) {
+			for (const auto& node : characterNodes)
+				for (const auto type : types)
+					if (node.Type == static_cast<uint16_t>(type))
+						fn(node);
+		};
+
+		out << YAML::BeginMap;
+		out << YAML::Key << "Name" << YAML::Value << str(character.Name);
+
+		out << YAML::Key << "EntryNode" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::Entry }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitTargets(node, 0);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "VariableNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::BoolVariable, NodeType::IntVariable }, [&](const NodeRecord& node) {
+			const bool isBool = node.Type == static_cast<uint16_t>(NodeType::BoolVariable);
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "Type" << YAML::Value << (isBool ? "Boolean" : "Integer");
+			out << YAML::Key << "Name" << YAML::Value << str(node.Text);
+			out << YAML::Key << "Operator" << YAML::Value << SerializeSetOperator(static_cast<SetOperator>(node.Operator));
+			if (isBool)
+				out << YAML::Key << "Value" << YAML::Value << (node.Value != 0);
+			else
+				out << YAML::Key << "Value" << YAML::Value << node.Value;
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitTargets(node, 0);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "ActNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::Act }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << node.ID;
+			out << YAML::Key << "Title" << YAML::Value << str(node.Text);
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitTargets(node, 0);
+			out << YAML::Key << "Bubbles" << YAML::Value;
+			out << YAML::BeginSeq;
+			for (const auto& bubble : GetBubbles().subspan(node.FirstOperand, node.OperandCount))
+			{
+				out << YAML::BeginMap;
+				out << YAML::Key << "Speaker" << YAML::Value << SerializeSpeaker(static_cast<Speaker>(bubble.Speaker));
+				out << YAML::Key << "Line" << YAML::Value << str(bubble.Line);
+				out << YAML::EndMap;
+			}
+			out << YAML::EndSeq;
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "ForkNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::Fork }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "UUID" << YAML::Value << DecodeUUID(node.UUID);
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitAllTargets(node);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "BranchNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::Branch }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "Expressions" << YAML::Value;
+			out << YAML::BeginSeq;
+			for (const auto& expression : GetExpressions().subspan(node.FirstOperand, node.OperandCount))
+			{
+				out << YAML::BeginSeq << YAML::Indent(1);
+				for (const auto& condition : GetConditions().subspan(expression.FirstCondition, expression.ConditionCount))
+				{
+					out << YAML::BeginMap;
+					out << YAML::Key << "Name" << YAML::Value << str(condition.Name);
+					out << YAML::Key << "Operator" << YAML::Value << SerializeCompareOperator(static_cast<CompareOperator>(condition.Operator));
+					out << YAML::Key << "Value" << YAML::Value << condition.Value;
+					out << YAML::EndMap;
+				}
+				out << YAML::EndSeq;
+			}
+			out << YAML::EndSeq;
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitAllTargets(node);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "FlavorCheckNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::FlavorCheck }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "ForNpc" << YAML::Value << ((node.Flags & FLAG_CHECKING_NPC) != 0);
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitAllTargets(node);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "FlavorMatchNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::FlavorMatch }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitAllTargets(node);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "DialogueNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::Dialogue }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "Prompts" << YAML::Value;
+			out << YAML::BeginSeq;
+			for (const auto& prompt : GetPrompts().subspan(node.FirstOperand, node.OperandCount))
+				out << str(prompt);
+			out << YAML::EndSeq;
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitAllTargets(node);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "AcceptQuestNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::AcceptQuest }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "UUID" << YAML::Value << DecodeUUID(node.UUID);
+			out << YAML::Key << "Title" << YAML::Value << str(node.Text);
+			out << YAML::Key << "Description" << YAML::Value << str(node.Description);
+			out << YAML::Key << "Objectives" << YAML::Value;
+			out << YAML::BeginSeq;
+			for (const auto& objective : GetObjectives().subspan(node.FirstOperand, node.OperandCount))
+			{
+				out << YAML::BeginMap;
+				out << YAML::Key << "UUID" << YAML::Value << DecodeUUID(objective.UUID);
+				out << YAML::Key << "Title" << YAML::Value << str(objective.Title);
+				out << YAML::Key << "Description" << YAML::Value << str(objective.Description);
+				out << YAML::Key << "IsOptional" << YAML::Value << ((objective.Flags & FLAG_OPTIONAL) != 0);
+				out << YAML::EndMap;
+			}
+			out << YAML::EndSeq;
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitTargets(node, 0);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "ReturnQuestNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::ReturnQuest }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "QuestID" << YAML::Value << DecodeUUID(node.UUID);
+			out << YAML::Key << "Succeed" << YAML::Value << ((node.Flags & FLAG_SUCCEED) != 0);
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitTargets(node, 0);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "ObjectiveNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::Objective }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "QuestID" << YAML::Value << DecodeUUID(node.UUID);
+			out << YAML::Key << "ObjectiveID" << YAML::Value << DecodeUUID(node.SecondaryUUID);
+			out << YAML::Key << "Succeed" << YAML::Value << ((node.Flags & FLAG_SUCCEED) != 0);
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitTargets(node, 0);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "DiceNodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		each({ NodeType::Dice }, [&](const NodeRecord& node) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID;
+			out << YAML::Key << "Outputs" << YAML::Value;
+			emitAllTargets(node);
+			out << YAML::EndMap;
+		});
+		out << YAML::EndSeq;
+
+		out << YAML::EndMap;
+	}
+	out << YAML::EndSeq;
+	out << YAML::EndMap;
+}
+
+[[nodiscard]] std::array<uint8_t, 16> BinaryExport::EncodeUUID(const gte::uuid& id)
+{
+	auto hexToByte = [](char c) -> uint8_t {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		return 0;
+	};
+
+	std::array<uint8_t, 16> bytes = {};
+	size_t i = 0;
+	bool high = true;
+	for (const char c : id.str())
+	{
+		if (c == '-' || i >= bytes.size())
+			continue;
+		bytes[i] |= high ? hexToByte(c) << 4 : hexToByte(c);
+		i += high ? 0 : 1;
+		high = !high;
+	}
+	return bytes;
+}
+
+[[nodiscard]] std::string BinaryExport::DecodeUUID(const uint8_t(&bytes)[16])
+{
+	constexpr char hexDigits[] = "0123456789ABCDEF";
+	std::string result;
+	result.reserve(36);
+	for (size_t i = 0; i < 16; i++)
+	{
+		if (i == 4 || i == 6 || i == 8 || i == 10)
+			result += '-';
+		result += hexDigits[bytes[i] >> 4];
+		result += hexDigits[bytes[i] & 0xF];
+	}
+	return result;
+}
+
+
+
+std::string SerializeSetOperator(SetOperator pOperator)
+{
+	switch (pOperator)
+	{
+	case SetOperator::Assignment:	return "=";
+	case SetOperator::Add:			return "+=";
+	case SetOperator::Subtract:	return "-=";
+	case SetOperator::Multiple:		return "*=";
+	case SetOperator::Divide:		return "/=";
+	default:						return "";
+	}
+}
+
+std::string SerializeCompareOperator(CompareOperator pOperator)
+{
+	switch (pOperator)
+	{
+	case CompareOperator::Equality:			return "==";
+	case CompareOperator::Greater:			return ">";
+	case CompareOperator::Less:				return "<";
+	case CompareOperator::GreaterEquals:	return ">=";
+	case CompareOperator::LessEquals:		return "<=";
+	case CompareOperator::Different:		return "<>";
+	default:								return "";
+	}
+}
+
+std::string SerializeSpeaker(Speaker pSpeaker)
+{
+	switch (pSpeaker)
+	{
+	case Speaker::MainCharacter:	return "MainCharacter";
+	case Speaker::NPC:				return "NPC";
+	case Speaker::Internal:			return "Internal";
+	default:						return "";
+	}
+}
@@ -0,0 +1,354 @@
+#include <BinaryExportSerializer.h>
+#include <Components.h>
+#include <FileWriter.h>
+
+#include <cstring>
+
+BinaryExportSerializer::BinaryExportSerializer(Scene* scene)
+	: mScene(scene) {}
+
+bool BinaryExportSerializer::Serialize(const std::string& filepath)
+{
+	// Every table is rebuilt from the scene, a second export mustn't append to the first one
+	mQuestRecords.clear();
+	mQuestInputs.clear();
+	mCharacters.clear();
+	mNodes.clear();
+	mOutputs.clear();
+	mTargetIndices.clear();
+	mBubbles.clear();
+	mPrompts.clear();
+	mExpressions.clear();
+	mConditions.clear();
+	mObjectives.clear();
+	mStrings.clear();
+
+	AssignRecords();
+	mStrings.push_back('\0');//Default StringRefs point to an empty string
+	for (const auto& characterData : mScene->mAllData)
+	{
+		const auto& character = characterData.Self;
+		auto& record = mCharacters.emplace_back();
+		record.Name = AddString(characterData.Name);
+		record.FirstNode = static_cast<uint32_t>(mNodes.size());
+		BuildTargets(character, record.FirstNode);
+
+		EachNode(character, [this, &record](NodeType type, const entt::registry& reg, entt::entity entityID) {
+			if (type == NodeType::Entry && record.Entry == BinaryExport::NONE)
+				record.Entry = static_cast<uint32_t>(mNodes.size());
+			WriteNode(type, reg, entityID);
+		});
+		record.NodeCount = static_cast<uint32_t>(mNodes.size()) - record.FirstNode;
+	}
+
+	// Header and section table first, then every section aligned right after the previous one
+	std::vector<BinaryExport::Section> sections;
+	uint64_t offset = sizeof(BinaryExport::Header) + static_cast<uint64_t>(BinaryExport::SectionType::Count) * sizeof(BinaryExport::Section);
+	auto addSection = [&sections, &offset](BinaryExport::SectionType type, size_t count, size_t size) {
+		offset = (offset + BinaryExport::ALIGNMENT - 1) & ~(uint64_t)(BinaryExport::ALIGNMENT - 1);
+		sections.push_back({ type, static_cast<uint32_t>(count), offset, size });
+		offset += size;
+	};
+	auto addVector = [&addSection](BinaryExport::SectionType type, const auto& records) {
+		addSection(type, records.size(), records.size() * sizeof(records[0]));
+	};
+
+	addVector(BinaryExport::SectionType::Characters, mCharacters);
+	addVector(BinaryExport::SectionType::Nodes, mNodes);
+	addVector(BinaryExport::SectionType::Outputs, mOutputs);
+	addVector(BinaryExport::SectionType::Targets, mTargetIndices);
+	addVector(BinaryExport::SectionType::Bubbles, mBubbles);
+	addVector(BinaryExport::SectionType::Prompts, mPrompts);
+	addVector(BinaryExport::SectionType::Expressions, mExpressions);
+	addVector(BinaryExport::SectionType::Conditions, mConditions);
+	addVector(BinaryExport::SectionType::Objectives, mObjectives);
+	addVector(BinaryExport::SectionType::Strings, mStrings);
+
+	BinaryExport::Header header;
+	std::memcpy(header.Magic, BinaryExport::MAGIC, sizeof(header.Magic));
+	header.VersionMajor = BinaryExport::VERSION_MAJOR;
+	header.VersionMinor = BinaryExport::VERSION_MINOR;
+	header.SectionCount = static_cast<uint32_t>(sections.size());
+	header.FileSize = offset;
+
+	FileWriter file(filepath, std::ios::binary);
+	auto& os = file.GetStream();
+	os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	os.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(BinaryExport::Section));
+
+	size_t written = sizeof(header) + sections.size() * sizeof(BinaryExport::Section);
+	auto writeSection = [&file, &os, &written, &sections](BinaryExport::SectionType type, const void* data) {
+		const auto& section = sections[static_cast<size_t>(type)];
+		static constexpr char padding[BinaryExport::ALIGNMENT] = {};
+		os.write(padding, section.Offset - written);
+		os.write(static_cast<const char*>(data), section.Size);
+		written = section.Offset + section.Size;
+		file.Flush();
+	};
+
+	writeSection(BinaryExport::SectionType::Characters, mCharacters.data());
+	writeSection(BinaryExport::SectionType::Nodes, mNodes.data());
+	writeSection(BinaryExport::SectionType::Outputs, mOutputs.data());
+	writeSection(BinaryExport::SectionType::Targets, mTargetIndices.data());
+	writeSection(BinaryExport::SectionType::Bubbles, mBubbles.data());
+	writeSection(BinaryExport::SectionType::Prompts, mPrompts.data());
+	writeSection(BinaryExport::SectionType::Expressions, mExpressions.data());
+	writeSection(BinaryExport::SectionType::Conditions, mConditions.data());
+	writeSection(BinaryExport::SectionType::Objectives, mObjectives.data());
+	writeSection(BinaryExport::SectionType::Strings, mStrings.data());
+
+	return file.Commit();
+}
+
+template<typename Fn>
+void BinaryExportSerializer::EachNode(const Character& character, Fn&& fn) const
+{
+	const auto& reg = character.mECS;
+	for (auto entityID : reg.view<Node, Pin>())								fn(NodeType::Entry, reg, entityID);
+	for (auto entityID : reg.view<VariableNode<bool>, InputOutput>())		fn(NodeType::BoolVariable, reg, entityID);
+	for (auto entityID : reg.view<VariableNode<int32_t>, InputOutput>())	fn(NodeType::IntVariable, reg, entityID);
+	for (auto entityID : reg.view<ActNode, InputOutput>())					fn(NodeType::Act, reg, entityID);
+	for (auto entityID : reg.view<ForkNode, ForkInputOutput>())				fn(NodeType::Fork, reg, entityID);
+	for (auto entityID : reg.view<BranchNode, InputOutputs>())				fn(NodeType::Branch, reg, entityID);
+	for (auto entityID : reg.view<FlavorCheckNode, InputOutputs>())			fn(NodeType::FlavorCheck, reg, entityID);
+	for (auto entityID : reg.view<FlavorMatchNode, ForkInputOutput>())		fn(NodeType::FlavorMatch, reg, entityID);
+	for (auto entityID : reg.view<DialogueNode, InputOutputs>())			fn(NodeType::Dialogue, reg, entityID);
+
+	for (auto&& [entityID, node, pins] : Character::sQuestECS.view<AcceptQuestNode, InputOutput>().each())
+		if (node.Owner == character.mID)
+			fn(NodeType::AcceptQuest, Character::sQuestECS, entityID);
+
+	for (auto entityID : reg.view<ReturnQuestNode, InputOutput>())			fn(NodeType::ReturnQuest, reg, entityID);
+	for (auto entityID : reg.view<ObjectiveNode, InputOutput>())			fn(NodeType::Objective, reg, entityID);
+	for (auto entityID : reg.view<DiceNode, InputOutputs>())				fn(NodeType::Dice, reg, entityID);
+}
+
+void BinaryExportSerializer::AssignRecords(void)
+{
+	uint32_t record = 0;
+	for (const auto& characterData : mScene->mAllData)
+	{
+		EachNode(characterData.Self, [this, &record](NodeType type, const entt::registry&, entt::entity entityID) {
+			if (type == NodeType::AcceptQuest)
+				mQuestRecords.emplace(entityID, record);
+			record++;
+		});
+	}
+
+	// Quests without an owner aren't exported and there's no record to point at, so links to them are dropped.
+	// ExportSerializer keeps them with the quest's ID instead, a text reader can tell it apart from a missing node
+	for (auto&& [entityID, pins] : Character::sQuestECS.view<InputOutput>().each())
+	{
+		auto it = mQuestRecords.find(entityID);
+		mQuestInputs.try_emplace(pins.Input.ID, it != mQuestRecords.end() ? it->second : BinaryExport::NONE);
+	}
+}
+
+void BinaryExportSerializer::BuildTargets(const Character& character, uint32_t firstNode)
+{
+	const auto& reg = character.mECS;
+	std::unordered_map<ed::PinId, uint32_t, IdHash<ed::PinId>> inputs;
+	uint32_t record = firstNode;
+	EachNode(character, [&inputs, &record](NodeType type, const entt::registry& nodeReg, entt::entity entityID) {
+		const uint32_t current = record++;
+		if (type == NodeType::AcceptQuest)
+			return;//Quests live in their own registry, their inputs come from mQuestInputs
+
+		const Pin* input = nullptr;
+		if (auto* pins = nodeReg.try_get<InputOutput>(entityID))
+			input = &pins->Input;
+		else if (auto* pins = nodeReg.try_get<ForkInputOutput>(entityID))
+			input = &pins->Input;
+		else if (auto* pins = nodeReg.try_get<InputOutputs>(entityID))
+			input = &pins->Input;
+
+		if (input)
+			inputs.try_emplace(input->ID, current);
+	});
+
+	mTargets.clear();
+	for (auto&& [entityID, link] : reg.view<Link>().each())
+	{
+		uint32_t target = BinaryExport::NONE;
+		if (auto it = inputs.find(link.EndPinID); it != inputs.end())
+			target = it->second;
+		else if (auto it = mQuestInputs.find(link.EndPinID); it != mQuestInputs.end())
+			target = it->second;
+
+		if (target != BinaryExport::NONE)
+			mTargets[link.StartPinID].emplace_back(target);
+	}
+}
+
+void BinaryExportSerializer::WriteNode(NodeType type, const entt::registry& reg, entt::entity entityID)
+{
+	auto& record = mNodes.emplace_back();
+	record.Type = static_cast<uint16_t>(type);
+	record.FirstOutput = static_cast<uint32_t>(mOutputs.size());
+	auto setUUID = [](uint8_t(&bytes)[16], const gte::uuid& id) {
+		const auto encoded = BinaryExport::EncodeUUID(id);
+		std::memcpy(bytes, encoded.data(), sizeof(bytes));
+	};
+
+	switch (type)
+	{
+	case NodeType::Entry:
+	{
+		record.ID = static_cast<int32_t>(reg.get<Node>(entityID).ID.Get());
+		WriteOutput(reg.get<Pin>(entityID));
+		break;
+	}
+	case NodeType::BoolVariable:
+	{
+		const auto& node = reg.get<VariableNode<bool>>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.Operator = static_cast<uint8_t>(node.Operator);
+		record.Value = node.Value;
+		record.Text = AddString(node.VariableName);
+		WriteOutput(reg.get<InputOutput>(entityID).Output);
+		break;
+	}
+	case NodeType::IntVariable:
+	{
+		const auto& node = reg.get<VariableNode<int32_t>>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.Operator = static_cast<uint8_t>(node.Operator);
+		record.Value = node.Value;
+		record.Text = AddString(node.VariableName);
+		WriteOutput(reg.get<InputOutput>(entityID).Output);
+		break;
+	}
+	case NodeType::Act:
+	{
+		const auto& node = reg.get<ActNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.Text = AddString(node.Title);
+		record.FirstOperand = static_cast<uint32_t>(mBubbles.size());
+		record.OperandCount = static_cast<uint32_t>(node.Bubbles.size());
+		for (const auto& [speaker, line] : node.Bubbles)
+			mBubbles.push_back({ AddString(line), static_cast<uint32_t>(speaker) });
+		WriteOutput(reg.get<InputOutput>(entityID).Output);
+		break;
+	}
+	case NodeType::Fork:
+	{
+		const auto& node = reg.get<ForkNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		setUUID(record.UUID, node.UUID);
+		for (const auto& output : reg.get<ForkInputOutput>(entityID).Outputs)
+			WriteOutput(output);
+		break;
+	}
+	case NodeType::Branch:
+	{
+		const auto& node = reg.get<BranchNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.FirstOperand = static_cast<uint32_t>(mExpressions.size());
+		record.OperandCount = static_cast<uint32_t>(node.Expressions.size());
+		for (const auto& expression : node.Expressions)
+		{
+			mExpressions.push_back({ static_cast<uint32_t>(mConditions.size()), static_cast<uint32_t>(expression.size()) });
+			for (const auto& condition : expression)
+				mConditions.push_back({ AddString(condition.VariableName), static_cast<uint32_t>(condition.Operator), condition.Value });
+		}
+		for (const auto& output : reg.get<InputOutputs>(entityID).Outputs)
+			WriteOutput(output);
+		break;
+	}
+	case NodeType::FlavorCheck:
+	{
+		const auto& node = reg.get<FlavorCheckNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.Flags = node.CheckingNPC ? BinaryExport::FLAG_CHECKING_NPC : 0;
+		for (const auto& output : reg.get<InputOutputs>(entityID).Outputs)
+			WriteOutput(output);
+		break;
+	}
+	case NodeType::FlavorMatch:
+	{
+		record.ID = static_cast<int32_t>(reg.get<FlavorMatchNode>(entityID).ID.Get());
+		for (const auto& output : reg.get<ForkInputOutput>(entityID).Outputs)
+			WriteOutput(output);
+		break;
+	}
+	case NodeType::Dialogue:
+	{
+		const auto& node = reg.get<DialogueNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.FirstOperand = static_cast<uint32_t>(mPrompts.size());
+		record.OperandCount = static_cast<uint32_t>(node.Prompts.size());
+		for (const auto& prompt : node.Prompts)
+			mPrompts.push_back(AddString(prompt));
+		for (const auto& output : reg.get<InputOutputs>(entityID).Outputs)
+			WriteOutput(output);
+		break;
+	}
+	case NodeType::AcceptQuest:
+	{
+		const auto& node = reg.get<AcceptQuestNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.Text = AddString(node.Title);
+		record.Description = AddString(node.Description);
+		setUUID(record.UUID, node.UUID);
+		record.FirstOperand = static_cast<uint32_t>(mObjectives.size());
+		record.OperandCount = static_cast<uint32_t>(node.Objectives.size());
+		for (const auto& objective : node.Objectives)
+		{
+			auto& objectiveRecord = mObjectives.emplace_back();
+			setUUID(objectiveRecord.UUID, objective.UUID);
+			objectiveRecord.Title = AddString(objective.Title);
+			objectiveRecord.Description = AddString(objective.Description);
+			objectiveRecord.Flags = objective.IsOptional ? BinaryExport::FLAG_OPTIONAL : 0;
+		}
+		WriteOutput(reg.get<InputOutput>(entityID).Output);
+		break;
+	}
+	case NodeType::ReturnQuest:
+	{
+		const auto& node = reg.get<ReturnQuestNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.Flags = node.Succeed ? BinaryExport::FLAG_SUCCEED : 0;
+		setUUID(record.UUID, node.QuestID);
+		WriteOutput(reg.get<InputOutput>(entityID).Output);
+		break;
+	}
+	case NodeType::Objective:
+	{
+		const auto& node = reg.get<ObjectiveNode>(entityID);
+		record.ID = static_cast<int32_t>(node.ID.Get());
+		record.Flags = node.Succeed ? BinaryExport::FLAG_SUCCEED : 0;
+		setUUID(record.UUID, node.QuestID);
+		setUUID(record.SecondaryUUID, node.ObjectiveID);
+		WriteOutput(reg.get<InputOutput>(entityID).Output);
+		break;
+	}
+	case NodeType::Dice:
+	{
+		record.ID = static_cast<int32_t>(reg.get<DiceNode>(entityID).ID.Get());
+		for (const auto& output : reg.get<InputOutputs>(entityID).Outputs)
+			WriteOutput(output);
+		break;
+	}
+	default:
+		break;
+	}
+
+	record.OutputCount = static_cast<uint32_t>(mOutputs.size()) - record.FirstOutput;
+}
+
+void BinaryExportSerializer::WriteOutput(const Pin& pin)
+{
+	auto& output = mOutputs.emplace_back();
+	output.FirstTarget = static_cast<uint32_t>(mTargetIndices.size());
+	if (auto it = mTargets.find(pin.ID); it != mTargets.end())
+		mTargetIndices.insert(mTargetIndices.end(), it->second.begin(), it->second.end());
+	output.TargetCount = static_cast<uint32_t>(mTargetIndices.size()) - output.FirstTarget;
+}
+
+[[nodiscard]] BinaryExport::StringRef BinaryExportSerializer::AddString(std::string_view str)
+{
+	const BinaryExport::StringRef ref = { static_cast<uint32_t>(mStrings.size()), static_cast<uint32_t>(str.size()) };
+	mStrings.append(str);
+	mStrings.push_back('\0');
+	return ref;
+}
@@ -7,24 +7,28 @@
 #include <algorithm>
 
 #include <SceneSerializer.h>
-#include <Random.h>
 
 using namespace ax;
 
 const ed::PinId INVALID_PIN_ID = ed::PinId{ 0 };
 static ImTextureID sHeaderBackground;
 
-static bool IsFlavorMatching(Flavor lhs, Flavor rhs);
-
 static bool IsFlavorSame(Flavor lhs, Flavor rhs);
 
 static void AddNewLines(char* text, size_t N = 32);
 
-entt::registry Character::sQuestECS;
-size_t Character::sNextID = 0;
+thread_local entt::registry Character::sQuestECS;
+thread_local size_t Character::sNextID = 0;
 
 [[nodiscard]] ImTextureID& GetHeaderBackground()
 {
+    // Loaded on first use, so Characters can be created without a renderer
+    static bool loaded = false;
+    if (!loaded)
+    {
+        sHeaderBackground = Application_LoadTexture("Data/BlueprintBackground.png");
+        loaded = true;
+    }
     return sHeaderBackground;
 }
 
@@ -56,7 +60,7 @@ std::string Character::FindSelectedObjectiveTitle(const gte::uuid& questSelectio
     return "Select Objective";
 }
 
-void Character::RenderHeader(NodeBuilder& builder, const char* name, const ImColor& color) const
+void Character::RenderHeader(NodeBuilder& builder, const char* name, const ImColor& color)
 {
     builder.Header(color);
 
@@ -64,12 +68,14 @@ void Character::RenderHeader(NodeBuilder& builder, const char* name, const ImCol
     ImGui::TextUnformatted(name);
     ImGui::Spring(1);
     ImGui::Dummy({ 0.0f, 28.0f });
+    if (mCurrentLayout)
+        mCurrentLayout->HeaderBottom = ImGui::GetItemRectMax().y;
 
     ImGui::Spring(0);
     builder.EndHeader();
 }
 
-void Character::RenderInput(NodeBuilder& builder, const Pin& input) const
+void Character::RenderInput(NodeBuilder& builder, const Pin& input)
 {
     auto alpha = ImGui::GetStyle().Alpha;
     if (mNewLinkPin && !CanCreateLink(*mNewLinkPin, input) && &input != mNewLinkPin)
@@ -86,9 +92,12 @@ void Character::RenderInput(NodeBuilder& builder, const Pin& input) const
     }
     ImGui::PopStyleVar();
     builder.EndInput();
+
+    if (mCurrentLayout)
+        mCurrentLayout->Pins.push_back({ input.ID, ed::PinKind::Input, ImGui::GetItemRectMin(), ImGui::GetItemRectMax() });
 }
 
-void Character::RenderOutput(NodeBuilder& builder, const Pin& output) const
+void Character::RenderOutput(NodeBuilder& builder, const Pin& output)
 {
     builder.Output(output.ID);
     auto alpha = ImGui::GetStyle().Alpha;
@@ -105,6 +114,101 @@ void Character::RenderOutput(NodeBuilder& builder, const Pin& output) const
     DrawPinIcon(output, IsPinLinked(output.ID), (int)(alpha * 255));
     ImGui::PopStyleVar();
     builder.EndOutput();
+
+    if (mCurrentLayout)
+        mCurrentLayout->Pins.push_back({ output.ID, ed::PinKind::Output, ImGui::GetItemRectMin(), ImGui::GetItemRectMax() });
+}
+
+bool Character::BeginNodeLayout(ed::NodeId nodeId, const char* name, const ImColor& color)
+{
+    auto& layout = mNodeLayouts[nodeId];
+    if (layout.Size.x <= 0.0f)
+    {
+        // Never rendered yet, its size and pins are only known after a full render
+        layout.Pins.clear();
+        mCurrentLayout = &layout;
+        return true;
+    }
+
+    const auto max = layout.Position + layout.Size;
+    const bool visible = max.x >= mVisibleMin.x && layout.Position.x <= mVisibleMax.x
+        && max.y >= mVisibleMin.y && layout.Position.y <= mVisibleMax.y;
+    if (visible && mZoom < sCompactZoom)
+    {
+        layout.Pins.clear();
+        mCurrentLayout = &layout;
+        return true;
+    }
+
+    // Same footprint as the real node, only the pins are submitted so links still attach to them
+    ed::PushStyleVar(ed::StyleVar_NodePadding, ImVec4(0, 0, 0, 0));
+    ed::BeginNode(nodeId);
+    const auto origin = ImGui::GetCursorScreenPos();
+    for (const auto& pin : layout.Pins)
+    {
+        const auto min = origin + pin.Min;
+        const auto max = origin + pin.Max;
+        const float pivotX = pin.Kind == ed::PinKind::Input ? min.x : max.x;
+        const ImVec2 pivot(pivotX, (min.y + max.y) * 0.5f);
+        ed::BeginPin(pin.ID, pin.Kind);
+        ed::PinRect(min, max);
+        ed::PinPivotRect(pivot, pivot);
+        ed::EndPin();
+    }
+    ImGui::SetCursorScreenPos(origin);
+    ImGui::Dummy(layout.Size);
+    ed::EndNode();
+    ed::PopStyleVar();
+
+    // A placeholder dragged into view is rendered in full on the next frame
+    layout.Position = ImGui::GetItemRectMin();
+    if (visible)
+        RenderCompactNode(nodeId, layout, name, color);
+    return false;
+}
+
+void Character::RenderCompactNode(ed::NodeId nodeId, const NodeLayout& layout, const char* name, const ImColor& color) const
+{
+    auto* drawList = ed::GetNodeBackgroundDrawList(nodeId);
+    const auto alpha = static_cast<int>(255 * ImGui::GetStyle().Alpha);
+    const auto headerMax = layout.Position + ImVec2(layout.Size.x, std::min(layout.HeaderBottom, layout.Size.y));
+    drawList->AddRectFilled(layout.Position, headerMax,
+        IM_COL32(0, 0, 0, alpha) | (ImU32(color) & IM_COL32(255, 255, 255, 0)), ed::GetStyle().NodeRounding, 1 | 2);
+
+    // Scaled against the zoom so the name stays readable, it's the only thing left to read
+    const float headerHeight = headerMax.y - layout.Position.y;
+    const float fontSize = std::min(ImGui::GetFontSize() * mZoom, headerHeight);
+    const ImVec4 clip(layout.Position.x, layout.Position.y, headerMax.x, headerMax.y);
+    const ImVec2 textPos(layout.Position.x + 8.0f, layout.Position.y + (headerHeight - fontSize) * 0.5f);
+    drawList->AddText(ImGui::GetFont(), fontSize, textPos, IM_COL32(255, 255, 255, alpha), name, nullptr, 0.0f, &clip);
+
+    const float radius = 4.0f * std::min(mZoom, 3.0f);
+    for (const auto& pin : layout.Pins)
+    {
+        const auto min = layout.Position + pin.Min;
+        const auto max = layout.Position + pin.Max;
+        const ImVec2 center(pin.Kind == ed::PinKind::Input ? min.x + radius : max.x - radius, (min.y + max.y) * 0.5f);
+        if (IsPinLinked(pin.ID))
+            drawList->AddCircleFilled(center, radius, IM_COL32(255, 255, 255, alpha));
+        else
+            drawList->AddCircle(center, radius, IM_COL32(255, 255, 255, alpha));
+    }
+}
+
+void Character::EndNodeLayout(void)
+{
+    if (!mCurrentLayout)
+        return;
+
+    mCurrentLayout->Position = ImGui::GetItemRectMin();
+    mCurrentLayout->Size = ImGui::GetItemRectSize();
+    mCurrentLayout->HeaderBottom -= mCurrentLayout->Position.y;
+    for (auto& pin : mCurrentLayout->Pins)
+    {
+        pin.Min -= mCurrentLayout->Position;
+        pin.Max -= mCurrentLayout->Position;
+    }
+    mCurrentLayout = nullptr;
 }
 
 
@@ -113,6 +217,12 @@ void Character::RenderNodes(void)
     auto* headerBackground = GetHeaderBackground();
     util::BlueprintNodeBuilder builder(headerBackground, Application_GetTextureWidth(headerBackground), Application_GetTextureHeight(headerBackground));
 
+    // The canvas pushes its visible rect as the clip rect, in canvas space
+    auto* drawList = ImGui::GetWindowDrawList();
+    mVisibleMin = drawList->GetClipRectMin() - ImVec2(sCullMargin, sCullMargin);
+    mVisibleMax = drawList->GetClipRectMax() + ImVec2(sCullMargin, sCullMargin);
+    mZoom = ed::GetCurrentZoom();
+
     {// Special node for enty only
         auto view = mECS.view<Node>();
         for (auto&& [entityID, node] : view.each())
@@ -138,6 +248,9 @@ void Character::RenderNodes(void)
         for (auto&& [entityID, node] : view.each())
         {
 
+            if (!BeginNodeLayout(node.ID, ActNode::NAME, ActNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, ActNode::NAME, ActNode::COLOR);
             const auto& pins = mECS.get<InputOutput>(entityID);
@@ -148,12 +261,14 @@ void Character::RenderNodes(void)
             ImGui::Spring(1, 0);
             ImGui::PushItemWidth(120.0f);
             ImGui::InputText("", node.Title, STR_LENGTH);
+            TrackEdit(node.ID);
             if (ImGui::Button("Edit"))
                 mOpenActNode = entityID;
             ImGui::Spring(0, 1);
 
             RenderOutput(builder, pins.Output);
             builder.End();
+            EndNodeLayout();
         }
 
         if (Scene::sWindows[Scene::ACT_INDEX] && mOpenActNode != entt::null && mECS.valid(mOpenActNode))
@@ -167,6 +282,7 @@ void Character::RenderNodes(void)
                 auto& node = view.get<ActNode>(mOpenActNode);
                 size_t i = 0;
                 size_t delIndex = INVALID_INDEX;
+                bool pressedAdd = false;
                 for (auto&& [speaker, line] : node.Bubbles)
                 {
                     const std::string btnLabel = "X##" + std::to_string(i);
@@ -177,21 +293,35 @@ void Character::RenderNodes(void)
                     ImGui::PopStyleColor();
                     ImGui::PushItemWidth(128.0f);
                     const std::string comboLabel = std::string("##combo") + std::to_string(i);
-                    ImGui::Combo(comboLabel.c_str(), (int32_t*)&speaker, typestr, IM_ARRAYSIZE(typestr)); ImGui::SameLine();
+                    int32_t iSpeaker = static_cast<int32_t>(speaker);
+                    if (ImGui::Combo(comboLabel.c_str(), &iSpeaker, typestr, IM_ARRAYSIZE(typestr)))
+                    {
+                        auto before = CaptureNode(node.ID);
+                        speaker = static_cast<Speaker>(iSpeaker);
+                        RecordEdit(std::move(before));
+                    }
+                    ImGui::SameLine();
                     ImGui::PopItemWidth();
                     char buffer[4096] = { 0 };
                     memcpy(buffer, line.c_str(), line.size() + 1);
                     const std::string textLabel = std::string("##line") + std::to_string(i);
                     if (ImGui::InputTextMultiline(textLabel.c_str(), buffer, 4096, { -1, 0 }))
                         line = buffer;
+                    TrackEdit(node.ID);
                     i++;
                 }
-                if (ImGui::Button("Add"))
-                    node.Bubbles.emplace_back(std::make_pair(Speaker::MainCharacter, ""));
+                pressedAdd = ImGui::Button("Add");
                 if (ImGui::Button("Close"))
                     mOpenActNode = entt::null;
-                if (delIndex != INVALID_INDEX)
-                    node.Bubbles.erase(node.Bubbles.begin() + delIndex);
+                if (pressedAdd || delIndex != INVALID_INDEX)
+                {
+                    auto before = CaptureNode(node.ID);
+                    if (pressedAdd)
+                        node.Bubbles.emplace_back(std::make_pair(Speaker::MainCharacter, ""));
+                    if (delIndex != INVALID_INDEX)
+                        node.Bubbles.erase(node.Bubbles.begin() + delIndex);
+                    RecordEdit(std::move(before));
+                }
             }
             ImGui::End();
             ed::Resume();
@@ -203,6 +333,9 @@ void Character::RenderNodes(void)
         for (auto&& [entityID, node] : view.each())
         {
 
+            if (!BeginNodeLayout(node.ID, ForkNode::NAME, ForkNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, ForkNode::NAME, ForkNode::COLOR);
             const auto& pins = mECS.get<ForkInputOutput>(entityID);
@@ -211,6 +344,7 @@ void Character::RenderNodes(void)
             RenderOutput(builder, pins.Outputs[0]);
             RenderOutput(builder, pins.Outputs[1]);
             builder.End();
+            EndNodeLayout();
         }
     }
 
@@ -219,6 +353,9 @@ void Character::RenderNodes(void)
         auto view = mECS.view<BranchNode>();
         for (auto&& [entityID, node] : view.each())
         {
+            if (!BeginNodeLayout(node.ID, BranchNode::NAME, BranchNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, BranchNode::NAME, BranchNode::COLOR);
             auto& pins = mECS.get<InputOutputs>(entityID);
@@ -247,12 +384,16 @@ void Character::RenderNodes(void)
                     ImGui::SameLine();
                 }
                 ImGui::TextUnformatted("if"); ImGui::SameLine();
-                ImGui::InputText("##name", expression[0].VariableName, STR_LENGTH); ImGui::SameLine();
+                ImGui::InputText("##name", expression[0].VariableName, STR_LENGTH);
+                TrackEdit(node.ID);
+                ImGui::SameLine();
                 const int32_t index = static_cast<int32_t>(expression[0].Operator);
                 if (ImGui::Button(operators[index], OPERATOR_BUTTON_SIZE))
                     iOperator = i;
                 ImGui::SameLine();
-                ImGui::DragScalar("##value", ImGuiDataType_S32, &expression[0].Value, 1.0f); ImGui::SameLine();
+                ImGui::DragScalar("##value", ImGuiDataType_S32, &expression[0].Value, 1.0f);
+                TrackEdit(node.ID);
+                ImGui::SameLine();
                 if (ImGui::Button(":", { 0.0f, OPERATOR_BUTTON_SIZE.y }))
                     mOpenExpression = std::make_pair(entityID, i);
                 ImGui::PopID();
@@ -267,6 +408,7 @@ void Character::RenderNodes(void)
             for(const auto& output : pins.Outputs)
                 RenderOutput(builder, output);
             builder.End();
+            EndNodeLayout();
             ed::Suspend();
             static int32_t indexOperator = -1;
             static entt::entity sEntityID = entt::null;
@@ -284,7 +426,9 @@ void Character::RenderNodes(void)
                 {
                     if (ImGui::MenuItem(operators[i]))
                     {
+                        auto before = CaptureNode(node.ID);
                         node.Expressions[0][indexOperator].Operator = static_cast<CompareOperator>(i);
+                        RecordEdit(std::move(before));
                         indexOperator = -1;
                     }
                 }
@@ -293,24 +437,31 @@ void Character::RenderNodes(void)
             ed::Resume();
             if (pressedAdd)
             {
+                auto before = CaptureNode(node.ID);
                 auto& expression = node.Expressions.emplace_back();
                 expression.emplace_back();
                 pins.Outputs.emplace(pins.Outputs.end() - 1, GetNextID(), "then", PinKind::Output);
+                IndexPins(entityID);
+                RecordEdit(std::move(before));
             }
             if (iRemove >= 0)
             {
+                // The link of the removed output goes first, so undoing brings the output back before it
+                auto before = CaptureNode(node.ID);
+                mHistory.BeginGroup();
                 node.Expressions.erase(node.Expressions.begin() + iRemove);
                 const auto it = pins.Outputs.begin() + iRemove;
-                auto links = mECS.view<Link>();
-                for (auto&& [entityID, link] : links.each())
+                if (const auto* link = FindLink(it->ID))
                 {
-                    if (link.StartPinID == it->ID)
-                    {
-                        mECS.remove<Link>(entityID);
-                        break;
-                    }
+                    const Link removed = *link;
+                    RemoveLink(removed.ID);
+                    mHistory.Push(std::make_unique<DeleteLinkAction>(removed));
                 }
+                mPinIndex.erase(it->ID);
                 pins.Outputs.erase(it);
+                IndexPins(entityID);
+                RecordEdit(std::move(before));
+                mHistory.EndGroup();
             }
         }
 
@@ -332,16 +483,23 @@ void Character::RenderNodes(void)
                     else ImGui::Dummy({ 28.0f, 0.0f });
                     ImGui::SameLine();
                     ImGui::PushItemWidth(128.0f);
-                    ImGui::InputText("##name", condition.VariableName, STR_LENGTH); ImGui::SameLine();
+                    ImGui::InputText("##name", condition.VariableName, STR_LENGTH);
+                    TrackEdit(nodeptr->ID);
+                    ImGui::SameLine();
                     ImGui::PopItemWidth();
                     int32_t iOp = static_cast<int32_t>(condition.Operator);
                     ImGui::PushItemWidth(64.0f);
                     if (ImGui::Combo("##operator", &iOp, operators, IM_ARRAYSIZE(operators)))
+                    {
+                        auto before = CaptureNode(nodeptr->ID);
                         condition.Operator = static_cast<CompareOperator>(iOp);
+                        RecordEdit(std::move(before));
+                    }
                     ImGui::PopItemWidth();
                     ImGui::SameLine();
                     ImGui::PushItemWidth(128.0f);
                     ImGui::DragScalar("##value", ImGuiDataType_S32, &condition.Value, 1.0f);
+                    TrackEdit(nodeptr->ID);
                     ImGui::PopItemWidth();
                     if (i > 0)
                     {
@@ -356,12 +514,18 @@ void Character::RenderNodes(void)
                     }
                     ImGui::PopID();
                 }
-                if (ImGui::Button("Add"))
-                    expression.emplace_back();
+                const bool pressedAdd = ImGui::Button("Add");
                 if (ImGui::Button("Close"))
                     mOpenExpression = std::make_pair(entt::null, -1);
-                if (iRemove >= 0)
-                    expression.erase(expression.begin() + iRemove);
+                if (pressedAdd || iRemove >= 0)
+                {
+                    auto before = CaptureNode(nodeptr->ID);
+                    if (pressedAdd)
+                        expression.emplace_back();
+                    if (iRemove >= 0)
+                        expression.erase(expression.begin() + iRemove);
+                    RecordEdit(std::move(before));
+                }
             }
             ImGui::End();
             ed::Resume();
@@ -372,6 +536,9 @@ void Character::RenderNodes(void)
         auto view = mECS.view<DialogueNode>();
         for (auto&& [entityID, node] : view.each())
         {
+            if (!BeginNodeLayout(node.ID, DialogueNode::NAME, DialogueNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, DialogueNode::NAME, DialogueNode::COLOR);
             auto& pins = mECS.get<InputOutputs>(entityID);
@@ -388,6 +555,7 @@ void Character::RenderNodes(void)
                 ImGui::PushItemWidth(124.0f);
                 if (ImGui::InputText("##prompt", buffer, 128))
                     prompt = std::string(buffer);
+                TrackEdit(node.ID);
                 ImGui::PopItemWidth();
                 ImGui::PopID();
             }
@@ -397,12 +565,16 @@ void Character::RenderNodes(void)
             for (const auto& output : pins.Outputs)
                 RenderOutput(builder, output);
             builder.End();
+            EndNodeLayout();
 
             ed::Suspend();
             if (pressedAdd)
             {
+                auto before = CaptureNode(node.ID);
                 node.Prompts.emplace_back("Another one");
                 pins.Outputs.emplace_back(GetNextID(), "", PinKind::Output);
+                IndexPins(entityID);
+                RecordEdit(std::move(before));
             }
             ed::Resume();
         }
@@ -412,6 +584,9 @@ void Character::RenderNodes(void)
         auto view = mECS.view<FlavorMatchNode>();
         for (auto&& [entityID, node] : view.each())
         {
+            if (!BeginNodeLayout(node.ID, FlavorMatchNode::NAME, FlavorMatchNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, FlavorMatchNode::NAME, FlavorMatchNode::COLOR);
             auto& pins = mECS.get<ForkInputOutput>(entityID);
@@ -419,6 +594,7 @@ void Character::RenderNodes(void)
             for (const auto& output : pins.Outputs)
                 RenderOutput(builder, output);
             builder.End();
+            EndNodeLayout();
         }
     }
 
@@ -426,8 +602,11 @@ void Character::RenderNodes(void)
         auto view = mECS.view<FlavorCheckNode>();
         for (auto&& [entityID, node] : view.each())
         {
-            builder.Begin(node.ID);
             const auto name = std::string(FlavorCheckNode::NAME) + "(" + (node.CheckingNPC ? "NPC" : "Main Character") + ")";
+            if (!BeginNodeLayout(node.ID, name.c_str(), FlavorCheckNode::COLOR))
+                continue;
+
+            builder.Begin(node.ID);
             RenderHeader(builder, name.c_str(), FlavorCheckNode::COLOR);
             auto& pins = mECS.get<InputOutputs>(entityID);
 
@@ -435,6 +614,7 @@ void Character::RenderNodes(void)
             for (const auto& output : pins.Outputs)
                 RenderOutput(builder, output);
             builder.End();
+            EndNodeLayout();
         }
     }
 
@@ -442,6 +622,9 @@ void Character::RenderNodes(void)
         auto view = mECS.view<DiceNode>();
         for (auto&& [entityID, node] : view.each())
         {
+            if (!BeginNodeLayout(node.ID, DiceNode::NAME, DiceNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, DiceNode::NAME, DiceNode::COLOR);
             auto& pins = mECS.get<InputOutputs>(entityID);
@@ -477,22 +660,31 @@ void Character::RenderNodes(void)
             for (const auto& output : pins.Outputs)
                 RenderOutput(builder, output);
             builder.End();
+            EndNodeLayout();
             ed::Suspend();
             if (pressedAdd)
+            {
+                auto before = CaptureNode(node.ID);
                 pins.Outputs.emplace_back(GetNextID(), PinKind::Output);
+                IndexPins(entityID);
+                RecordEdit(std::move(before));
+            }
             if (iRemove > 1)
             {
+                auto before = CaptureNode(node.ID);
+                mHistory.BeginGroup();
                 const auto it = pins.Outputs.begin() + iRemove;
-                auto links = mECS.view<Link>();
-                for (auto&& [entityID, link] : links.each())
+                if (const auto* link = FindLink(it->ID))
                 {
-                    if (link.StartPinID == it->ID)
-                    {
-                        mECS.remove<Link>(entityID);
-                        break;
-                    }
+                    const Link removed = *link;
+                    RemoveLink(removed.ID);
+                    mHistory.Push(std::make_unique<DeleteLinkAction>(removed));
                 }
+                mPinIndex.erase(it->ID);
                 pins.Outputs.erase(it);
+                IndexPins(entityID);
+                RecordEdit(std::move(before));
+                mHistory.EndGroup();
             }
             ed::Resume();
         }
@@ -505,6 +697,9 @@ void Character::RenderNodes(void)
             if (node.Owner != mID)
                 continue;
 
+            if (!BeginNodeLayout(node.ID, AcceptQuestNode::NAME, AcceptQuestNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, AcceptQuestNode::NAME, AcceptQuestNode::COLOR);
             RenderInput(builder, pins.Input);
@@ -512,11 +707,13 @@ void Character::RenderNodes(void)
             builder.Middle();
             ImGui::Spring(1, 0);
             ImGui::InputText("##Title", node.Title, 64);
+            TrackEdit(node.ID);
             if (ImGui::Button("Edit"))
                 mOpenAcceptQuest = entityID;
             ImGui::Spring(1, 0);
             RenderOutput(builder, pins.Output);
             builder.End();
+            EndNodeLayout();
         }
 
         if (Scene::sWindows[Scene::QUEST_INDEX]
@@ -530,6 +727,7 @@ void Character::RenderNodes(void)
                 ImGui::TextUnformatted("Description:"); ImGui::SameLine();
                 AddNewLines(node.Description);
                 ImGui::InputTextMultiline("##Description", node.Description, 512);
+                TrackEdit(node.ID);
                 ImGui::TextUnformatted("Objectives:");
                 int32_t iRemove = -1;
                 for (int32_t i = 0; i < node.Objectives.size(); i++)
@@ -546,16 +744,25 @@ void Character::RenderNodes(void)
 
                     ImGui::TextUnformatted("Is Optional:"); ImGui::SameLine();
                     ImGui::Checkbox("##Optional", &objective.IsOptional);
+                    TrackEdit(node.ID);
                     ImGui::InputText("##ObjectiveTitle", objective.Title, STR_LENGTH);
+                    TrackEdit(node.ID);
                     AddNewLines(objective.Description);
                     ImGui::InputTextMultiline("##ObjectiveDescription", objective.Description, 512);
+                    TrackEdit(node.ID);
                     ImGui::Separator();
                     ImGui::PopID();
                 }
-                if (iRemove != -1)
-                    node.Objectives.erase(node.Objectives.begin() + iRemove);
-                if (ImGui::Button("Add"))
-                    node.Objectives.emplace_back();
+                const bool pressedAdd = ImGui::Button("Add");
+                if (pressedAdd || iRemove != -1)
+                {
+                    auto before = CaptureNode(node.ID);
+                    if (iRemove != -1)
+                        node.Objectives.erase(node.Objectives.begin() + iRemove);
+                    if (pressedAdd)
+                        node.Objectives.emplace_back();
+                    RecordEdit(std::move(before));
+                }
                 if (ImGui::Button("Close"))
                     mOpenAcceptQuest = entt::null;
             }
@@ -569,6 +776,9 @@ void Character::RenderNodes(void)
         static entt::entity sSelectingQuest = entt::null;
         for (auto&& [entityID, node] : view.each())
         {
+            if (!BeginNodeLayout(node.ID, ReturnQuestNode::NAME, ReturnQuestNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, ReturnQuestNode::NAME, ReturnQuestNode::COLOR);
             auto& pins = mECS.get<InputOutput>(entityID);
@@ -578,10 +788,13 @@ void Character::RenderNodes(void)
             const auto selection = FindSelectedQuestTitle(node.QuestID);
             const bool pressed = ImGui::Button(selection.c_str());
             if (ImGui::RadioButton("Succeed", node.Succeed)) node.Succeed = true;
+            TrackEdit(node.ID);
             if (ImGui::RadioButton("Failed", !node.Succeed)) node.Succeed = false;
+            TrackEdit(node.ID);
             ImGui::Spring(1, 0);
             RenderOutput(builder, pins.Output);
             builder.End();
+            EndNodeLayout();
 
             if (pressed)
             {
@@ -596,7 +809,9 @@ void Character::RenderNodes(void)
                 {
                     if (ImGui::MenuItem(quest.Title, nullptr, node.QuestID == quest.UUID))
                     {
+                        auto before = CaptureNode(node.ID);
                         node.QuestID = quest.UUID;
+                        RecordEdit(std::move(before));
                         sSelectingQuest = entt::null;
                     }
                 }
@@ -612,6 +827,9 @@ void Character::RenderNodes(void)
         static entt::entity sSelectingObjective = entt::null;
         for (auto&& [entityID, node] : view.each())
         {
+            if (!BeginNodeLayout(node.ID, ObjectiveNode::NAME, ObjectiveNode::COLOR))
+                continue;
+
             builder.Begin(node.ID);
             RenderHeader(builder, ObjectiveNode::NAME, ObjectiveNode::COLOR);
             auto& pins = mECS.get<InputOutput>(entityID);
@@ -624,10 +842,13 @@ void Character::RenderNodes(void)
             const bool pressedObjective = ImGui::Button(objectiveSelection.c_str());
             ImGui::Dummy({ 0.0f, 0.0f });
             if (ImGui::RadioButton("Succeed", node.Succeed)) node.Succeed = true;
+            TrackEdit(node.ID);
             if (ImGui::RadioButton("Failed", !node.Succeed)) node.Succeed = false;
+            TrackEdit(node.ID);
             ImGui::Spring(1, 0);
             RenderOutput(builder, pins.Output);
             builder.End();
+            EndNodeLayout();
 
             if (pressedQuest)
             {
@@ -647,7 +868,9 @@ void Character::RenderNodes(void)
                 {
                     if (ImGui::MenuItem(quest.Title, nullptr, node.QuestID == quest.UUID))
                     {
+                        auto before = CaptureNode(node.ID);
                         node.QuestID = quest.UUID;
+                        RecordEdit(std::move(before));
                         sSelectingQuest = entt::null;
                     }
                 }
@@ -664,7 +887,9 @@ void Character::RenderNodes(void)
                     {
                         if (ImGui::MenuItem(objective.Title, nullptr, node.ObjectiveID == objective.UUID))
                         {
+                            auto before = CaptureNode(node.ID);
                             node.ObjectiveID = objective.UUID;
+                            RecordEdit(std::move(before));
                             sSelectingQuest = entt::null;
                         }
                     }
@@ -695,6 +920,7 @@ void Character::RenderNodes(void)
                 strcpy(buffer, node.Comment.c_str());
                 if (ImGui::InputText("##Comment", buffer, 4096))
                     node.Comment = std::string(buffer);
+                TrackEdit(node.ID);
                 if (ImGui::IsMouseClicked(0) && !ImGui::IsItemHovered())
                     editingComment = entt::null;
             }
@@ -751,46 +977,197 @@ void Character::RenderNodes(void)
 
 [[nodiscard]] Pin Character::FindPin(entt::entity entityID, ed::PinId pinId) const
 {
-    if (auto* pin = mECS.try_get<Pin>(entityID))
-        if (pin->ID == pinId)
+    if (auto it = mPinIndex.find(pinId); it != mPinIndex.end() && it->second.Entity == entityID)
+        if (const auto* pin = LookupPin(pinId))
             return *pin;
-    if (auto* pins = mECS.try_get<InputOutput>(entityID))
+    return {};
+}
+
+[[nodiscard]] const Pin* Character::LookupPin(ed::PinId pinId) const
+{
+    auto it = mPinIndex.find(pinId);
+    if (it == mPinIndex.end())
+        return nullptr;
+
+    const auto& [entityID, inQuestECS, slot] = it->second;
+    const entt::registry& reg = inQuestECS ? sQuestECS : mECS;
+    if (auto* pin = reg.try_get<Pin>(entityID))
+        return pin;
+    if (auto* pins = reg.try_get<InputOutput>(entityID))
+        return slot == PinRef::INPUT_SLOT ? &pins->Input : &pins->Output;
+    if (auto* pins = reg.try_get<ForkInputOutput>(entityID))
+        return slot == PinRef::INPUT_SLOT ? &pins->Input : &pins->Outputs[slot];
+    if (auto* pins = reg.try_get<InputOutputs>(entityID))
+        return slot == PinRef::INPUT_SLOT ? &pins->Input : &pins->Outputs[slot];
+    return nullptr;
+}
+
+void Character::IndexPins(entt::entity entityID, bool inQuestECS)
+{
+    const entt::registry& reg = inQuestECS ? sQuestECS : mECS;
+    auto index = [this, entityID, inQuestECS](const Pin& pin, int32_t slot) {
+        mPinIndex[pin.ID] = PinRef{ entityID, inQuestECS, slot };
+    };
+
+    if (auto* pin = reg.try_get<Pin>(entityID))
+        index(*pin, 0);
+    if (auto* pins = reg.try_get<InputOutput>(entityID))
+    {
+        index(pins->Input, PinRef::INPUT_SLOT);
+        index(pins->Output, 0);
+    }
+    if (auto* pins = reg.try_get<ForkInputOutput>(entityID))
     {
-        if (pins->Input.ID == pinId)
-            return pins->Input;
-        if (pins->Output.ID == pinId)
-            return pins->Output;
+        index(pins->Input, PinRef::INPUT_SLOT);
+        for (size_t i = 0; i < pins->Outputs.size(); i++)
+            index(pins->Outputs[i], static_cast<int32_t>(i));
     }
+    if (auto* pins = reg.try_get<InputOutputs>(entityID))
+    {
+        index(pins->Input, PinRef::INPUT_SLOT);
+        for (size_t i = 0; i < pins->Outputs.size(); i++)
+            index(pins->Outputs[i], static_cast<int32_t>(i));
+    }
+}
 
-    if (auto* pins = mECS.try_get<ForkInputOutput>(entityID))
+void Character::UnindexPins(entt::entity entityID, bool inQuestECS)
+{
+    const entt::registry& reg = inQuestECS ? sQuestECS : mECS;
+    if (auto* pin = reg.try_get<Pin>(entityID))
+        mPinIndex.erase(pin->ID);
+    if (auto* pins = reg.try_get<InputOutput>(entityID))
     {
-        if (pins->Input.ID == pinId)
-            return pins->Input;
-        if (pins->Outputs[0].ID == pinId)
-            return pins->Outputs[0];
-        if (pins->Outputs[1].ID == pinId)
-            return pins->Outputs[1];
+        mPinIndex.erase(pins->Input.ID);
+        mPinIndex.erase(pins->Output.ID);
     }
+    if (auto* pins = reg.try_get<ForkInputOutput>(entityID))
+    {
+        mPinIndex.erase(pins->Input.ID);
+        for (const auto& output : pins->Outputs)
+            mPinIndex.erase(output.ID);
+    }
+    if (auto* pins = reg.try_get<InputOutputs>(entityID))
+    {
+        mPinIndex.erase(pins->Input.ID);
+        for (const auto& output : pins->Outputs)
+            mPinIndex.erase(output.ID);
+    }
+}
 
-    if (auto* pins = mECS.try_get<InputOutputs>(entityID))
+void Character::ValidateIndices(void) const
+{
+#ifdef PURU_DEBUG
+    size_t count = 0;
+    auto check = [this, &count](const Pin& pin, entt::entity entityID, bool inQuestECS, int32_t slot) {
+        auto it = mPinIndex.find(pin.ID);
+        IM_ASSERT(it != mPinIndex.end() && "Pin is missing from the index");
+        IM_ASSERT(it->second.Entity == entityID && it->second.InQuestECS == inQuestECS && it->second.Slot == slot && "Pin index is stale");
+        count++;
+    };
+
+    for (auto&& [entityID, pin] : mECS.view<Pin>().each())
+        check(pin, entityID, false, 0);
+    for (auto&& [entityID, pins] : mECS.view<InputOutput>().each())
+    {
+        check(pins.Input, entityID, false, PinRef::INPUT_SLOT);
+        check(pins.Output, entityID, false, 0);
+    }
+    for (auto&& [entityID, pins] : mECS.view<ForkInputOutput>().each())
     {
-        if (pins->Input.ID == pinId)
-            return pins->Input;
-        for (auto& output : pins->Outputs)
-            if (output.ID == pinId)
-                return output;
+        check(pins.Input, entityID, false, PinRef::INPUT_SLOT);
+        for (size_t i = 0; i < pins.Outputs.size(); i++)
+            check(pins.Outputs[i], entityID, false, static_cast<int32_t>(i));
     }
+    for (auto&& [entityID, pins] : mECS.view<InputOutputs>().each())
+    {
+        check(pins.Input, entityID, false, PinRef::INPUT_SLOT);
+        for (size_t i = 0; i < pins.Outputs.size(); i++)
+            check(pins.Outputs[i], entityID, false, static_cast<int32_t>(i));
+    }
+    for (auto&& [entityID, node, pins] : sQuestECS.view<AcceptQuestNode, InputOutput>().each())
+    {
+        if (node.Owner != mID)
+            continue;
+        check(pins.Input, entityID, true, PinRef::INPUT_SLOT);
+        check(pins.Output, entityID, true, 0);
+    }
+    IM_ASSERT(count == mPinIndex.size() && "Pin index contains removed pins");
 
-    if (auto* pins = sQuestECS.try_get<InputOutput>(entityID))
+    size_t nodeCount = 0;
+    auto checkNodes = [this, &nodeCount](const auto& view) {
+        for (auto&& [entityID, node] : view.each())
+        {
+            auto it = mNodeIndex.find(node.ID);
+            IM_ASSERT(it != mNodeIndex.end() && it->second == entityID && "Node index is stale");
+            nodeCount++;
+        }
+    };
+    checkNodes(mECS.view<Node>());
+    checkNodes(mECS.view<VariableNode<bool>>());
+    checkNodes(mECS.view<VariableNode<int32_t>>());
+    checkNodes(mECS.view<ActNode>());
+    checkNodes(mECS.view<ForkNode>());
+    checkNodes(mECS.view<BranchNode>());
+    checkNodes(mECS.view<DialogueNode>());
+    checkNodes(mECS.view<FlavorMatchNode>());
+    checkNodes(mECS.view<FlavorCheckNode>());
+    checkNodes(mECS.view<DiceNode>());
+    checkNodes(mECS.view<CommentNode>());
+    checkNodes(mECS.view<ReturnQuestNode>());
+    checkNodes(mECS.view<ObjectiveNode>());
+    for (auto&& [entityID, node] : sQuestECS.view<AcceptQuestNode>().each())
+    {
+        if (node.Owner != mID)
+            continue;
+        auto it = mNodeIndex.find(node.ID);
+        IM_ASSERT(it != mNodeIndex.end() && it->second == entityID && "Node index is stale");
+        nodeCount++;
+    }
+    IM_ASSERT(nodeCount == mNodeIndex.size() && "Node index contains removed nodes");
+
+    size_t linkCount = 0;
+    auto contains = [](const auto& adjacency, ed::PinId pinId, entt::entity entityID) {
+        auto it = adjacency.find(pinId);
+        return it != adjacency.end() && std::find(it->second.begin(), it->second.end(), entityID) != it->second.end();
+    };
+    for (auto&& [entityID, link] : mECS.view<Link>().each())
     {
-        if (pins->Input.ID == pinId)
-            return pins->Input;
-        if (pins->Output.ID == pinId)
-            return pins->Output;
+        IM_ASSERT(contains(mOutgoingLinks, link.StartPinID, entityID) && "Link is missing from the outgoing index");
+        IM_ASSERT(contains(mIncomingLinks, link.EndPinID, entityID) && "Link is missing from the incoming index");
+        linkCount++;
     }
+    auto countLinks = [](const auto& adjacency) {
+        size_t count = 0;
+        for (const auto& [pinId, links] : adjacency)
+            count += links.size();
+        return count;
+    };
+    IM_ASSERT(countLinks(mOutgoingLinks) == linkCount && countLinks(mIncomingLinks) == linkCount && "Link index contains removed links");
+#endif
+}
 
+void Character::IndexLink(entt::entity entityID)
+{
+    const auto& link = mECS.get<Link>(entityID);
+    mOutgoingLinks[link.StartPinID].emplace_back(entityID);
+    mIncomingLinks[link.EndPinID].emplace_back(entityID);
+}
 
-    return {};
+void Character::UnindexLink(entt::entity entityID)
+{
+    auto unlink = [entityID](auto& adjacency, ed::PinId pinId) {
+        auto it = adjacency.find(pinId);
+        if (it == adjacency.end())
+            return;
+        auto& links = it->second;
+        links.erase(std::remove(links.begin(), links.end(), entityID), links.end());
+        if (links.empty())
+            adjacency.erase(it);
+    };
+
+    const auto& link = mECS.get<Link>(entityID);
+    unlink(mOutgoingLinks, link.StartPinID);
+    unlink(mIncomingLinks, link.EndPinID);
 }
 
 //[[nodiscard]] const Pin Character::FindPin(entt::entity entityID, ed::PinId pinId) const { return FindPin(entityID, pinId); }
@@ -804,22 +1181,29 @@ void Character::RenderNodes(void)
     return nullptr;
 }
 
-[[nodiscard]] Link* Character::FindLink(ed::PinId pinID)
+[[nodiscard]] const Link* Character::FindLink(ed::PinId pinID) const
 {
-    auto view = mECS.view<Link>();
-    for (auto&& [entityID, link] : view.each())
-        if (link.StartPinID == pinID || link.EndPinID == pinID)
-            return &link;
-    return nullptr;
+    // Views walk the Link storage back to front, so the link a full scan
+    // would have found first is the one with the highest storage index
+    const auto* storage = mECS.storage<Link>();
+    entt::entity found = entt::null;
+    auto visit = [storage, &found, pinID](const auto& adjacency) {
+        auto it = adjacency.find(pinID);
+        if (it == adjacency.end())
+            return;
+        for (auto entityID : it->second)
+            if (found == entt::null || storage->index(entityID) > storage->index(found))
+                found = entityID;
+    };
+    visit(mOutgoingLinks);
+    visit(mIncomingLinks);
+
+    return found != entt::null ? &storage->get(found) : nullptr;
 }
 
 bool Character::IsPinLinked(ed::PinId id) const
 {
-    auto view = mECS.view<Link>();
-    for (auto&& [entityID, link] : view.each())
-        if (link.StartPinID == id || link.EndPinID == id)
-            return true;
-    return false;
+    return mOutgoingLinks.contains(id) || mIncomingLinks.contains(id);
 }
 
 bool Character::CanCreateLink(const Pin& a, const Pin& b) const
@@ -896,6 +1280,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<BranchNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
     auto& expression = node.Expressions.emplace_back();
     expression.emplace_back();
     auto& pins = mECS.emplace<InputOutputs>(entityID);
@@ -908,6 +1293,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
     Pin& pin1 = pins.Outputs.emplace_back(GetNextID(), "else", PinType::Flow);
     pin1.Kind = PinKind::Output;
 
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -915,6 +1301,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<ForkNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
 
     auto& pins = mECS.emplace<ForkInputOutput>(entityID);
     pins.Input = { GetNextID(), "", PinType::Flow };
@@ -925,6 +1312,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
     pins.Outputs[1] = { GetNextID(), "First", PinType::Flow };
     pins.Outputs[1].Kind = PinKind::Output;
 
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -934,6 +1322,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<ActNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
 
     auto& pins = mECS.emplace<InputOutput>(entityID);
     pins.Input = { GetNextID(), "", PinType::Flow };
@@ -942,6 +1331,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
     pins.Output = { GetNextID(), "", PinType::Flow };
     pins.Output.Kind = PinKind::Output;
 
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -949,6 +1339,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<DialogueNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
     node.Prompts.emplace_back("Something");
     node.Prompts.emplace_back("Something else");
 
@@ -959,6 +1350,7 @@ bool Character::Splitter(bool split_vertically, float thickness, float* size1, f
     pins.Outputs.emplace_back(GetNextID(), "", PinKind::Output, PinType::Flow);
     pins.Outputs.emplace_back(GetNextID(), "", PinKind::Output, PinType::Flow);
 
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -966,11 +1358,13 @@ entt::entity Character::SpawnFlavorMatch(void)
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<FlavorMatchNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
     
     auto& pins = mECS.emplace<ForkInputOutput>(entityID);
     pins.Input = { GetNextID(), "", PinKind::Input };
     pins.Outputs[0] = { GetNextID(), "Flavor matching", PinKind::Output };
     pins.Outputs[1] = { GetNextID(), "else", PinKind::Output };
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -978,6 +1372,7 @@ entt::entity Character::SpawnFlavorCheck(bool forNpc)
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<FlavorCheckNode>(entityID, GetNextID(), forNpc);
+    IndexNode(node, entityID);
 
     auto& pins = mECS.emplace<InputOutputs>(entityID);
     pins.Input = { GetNextID(), "", PinKind::Input };
@@ -987,6 +1382,7 @@ entt::entity Character::SpawnFlavorCheck(bool forNpc)
     pins.Outputs.emplace_back(GetNextID(), "Sour", PinKind::Output);
     pins.Outputs.emplace_back(GetNextID(), "Sweet", PinKind::Output);
     pins.Outputs.emplace_back(GetNextID(), "Neutral", PinKind::Output);
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -994,11 +1390,13 @@ entt::entity Character::SpawnDiceNode(void)
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<DiceNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
 
     auto& pins = mECS.emplace<InputOutputs>(entityID);
     pins.Input = { GetNextID(), "", PinKind::Input };
     pins.Outputs.emplace_back(GetNextID(), PinKind::Output);
     pins.Outputs.emplace_back(GetNextID(), PinKind::Output);
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -1006,6 +1404,7 @@ entt::entity Character::SpawnAcceptQuestNode(void)
 {
     const auto entityID = sQuestECS.create();
     auto& node = sQuestECS.emplace<AcceptQuestNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
     node.UUID = gte::uuid::Create();
     node.Owner = mID;
 
@@ -1013,6 +1412,7 @@ entt::entity Character::SpawnAcceptQuestNode(void)
     pins.Input = { GetNextID(), PinKind::Input };
     pins.Output = { GetNextID(), PinKind::Output };
 
+    IndexPins(entityID, true);
     return entityID;
 }
 
@@ -1021,11 +1421,13 @@ entt::entity Character::SpawnReturnQuestNode(void)
 
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<ReturnQuestNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
     
     auto& pins = mECS.emplace<InputOutput>(entityID);
     pins.Input = { GetNextID(), PinKind::Input };
     pins.Output = { GetNextID(), PinKind::Output };
 
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -1033,11 +1435,13 @@ entt::entity Character::SpawnObjectiveNode(void)
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<ObjectiveNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
 
     auto& pins = mECS.emplace<InputOutput>(entityID);
     pins.Input = { GetNextID(), "", PinKind::Input };
     pins.Output = { GetNextID(), "", PinKind::Output };
 
+    IndexPins(entityID);
     return entityID;
 }
 
@@ -1045,99 +1449,220 @@ entt::entity Character::SpawnCommentNode(void)
 {
     const auto entityID = mECS.create();
     auto& node = mECS.emplace<CommentNode>(entityID, GetNextID());
+    IndexNode(node, entityID);
     node.Comment = "Your comment";
     return entityID;
 }
 
 [[nodiscard]] entt::entity Character::FindEntity(ed::PinId pinId) const
 {
+    auto it = mPinIndex.find(pinId);
+    return it != mPinIndex.end() ? it->second.Entity : entt::null;
+}
+
+[[nodiscard]] entt::entity Character::FindEntity(ed::NodeId nodeId) const
+{
+    auto it = mNodeIndex.find(nodeId);
+    return it != mNodeIndex.end() ? it->second : entt::null;
+}
+
+bool Character::IsQuestNode(ed::NodeId nodeId, entt::entity entityID) const
+{
+    if (!sQuestECS.valid(entityID))
+        return false;
+    const auto* quest = sQuestECS.try_get<AcceptQuestNode>(entityID);
+    return quest && quest->ID == nodeId;
+}
+
+template<typename ...T>
+[[nodiscard]] static std::optional<NodeSnapshot::NodeComponent> CopyNode(const entt::registry& reg, entt::entity entityID, ed::NodeId nodeId)
+{
+    std::optional<NodeSnapshot::NodeComponent> copy;
+    auto visit = [&copy, nodeId](const auto* node) {
+        using Type = std::decay_t<decltype(*node)>;
+        if (!copy && node && node->ID == nodeId)
+            copy.emplace(std::in_place_type<Type>, *node);
+    };
+    (visit(reg.try_get<T>(entityID)), ...);
+    return copy;
+}
+
+std::optional<NodeSnapshot> Character::CaptureNode(ed::NodeId nodeId) const
+{
+    const auto entityID = FindEntity(nodeId);
+    if (entityID == entt::null)
+        return std::nullopt;
+
+    const bool inQuestECS = IsQuestNode(nodeId, entityID);
+    const entt::registry& reg = inQuestECS ? sQuestECS : mECS;
+    if (!reg.valid(entityID))
+        return std::nullopt;
+
+    auto self = CopyNode<
+        VariableNode<bool>, VariableNode<int32_t>,
+        ActNode, ForkNode, BranchNode, DialogueNode,
+        FlavorMatchNode, FlavorCheckNode, DiceNode,
+        AcceptQuestNode, ReturnQuestNode, ObjectiveNode,
+        CommentNode
+    >(reg, entityID, nodeId);
+    if (!self)
+        return std::nullopt;
+
+    // Every member is spelled out, the node variant has no default to assign over
+    NodeSnapshot snapshot{ std::move(*self), std::monostate{}, ImVec2{ 0.0f, 0.0f } };
+    if (const auto* pins = reg.try_get<InputOutput>(entityID))
+        snapshot.Pins = *pins;
+    else if (const auto* pins = reg.try_get<ForkInputOutput>(entityID))
+        snapshot.Pins = *pins;
+    else if (const auto* pins = reg.try_get<InputOutputs>(entityID))
+        snapshot.Pins = *pins;
+    if (ed::GetCurrentEditor())
+        snapshot.Position = ed::GetNodePosition(nodeId);
+    return snapshot;
+}
+
+void Character::RestoreNode(const NodeSnapshot& snapshot, bool place)
+{
+    const auto nodeId = snapshot.GetID();
+    const bool inQuestECS = snapshot.IsQuest();
+    mNodeLayouts.erase(nodeId);//Its pins may have changed, the next frame renders it in full
+    entt::registry& reg = inQuestECS ? sQuestECS : mECS;
+
+    auto entityID = FindEntity(nodeId);
+    if (entityID != entt::null && reg.valid(entityID) && (!inQuestECS || IsQuestNode(nodeId, entityID)))
+        UnindexPins(entityID, inQuestECS);
+    else
+        entityID = reg.create();
+
+    std::visit([this, &reg, entityID](const auto& node) {
+        using Type = std::decay_t<decltype(node)>;
+        auto& restored = reg.emplace_or_replace<Type>(entityID, node);
+        if constexpr (std::is_same_v<Type, AcceptQuestNode>)
+            restored.Owner = mID;
+        IndexNode(restored, entityID);
+    }, snapshot.Self);
+    std::visit([&reg, entityID](const auto& pins) {
+        using Type = std::decay_t<decltype(pins)>;
+        if constexpr (!std::is_same_v<Type, std::monostate>)
+            reg.emplace_or_replace<Type>(entityID, pins);
+    }, snapshot.Pins);
+    IndexPins(entityID, inQuestECS);
+
+    if (place && ed::GetCurrentEditor())
+        ed::SetNodePosition(nodeId, snapshot.Position);
+}
+
+void Character::RemoveNode(ed::NodeId nodeId)
+{
+    const auto entityID = FindEntity(nodeId);
+    if (entityID == entt::null)
+        return;
+
+    const bool inQuestECS = IsQuestNode(nodeId, entityID);
+    entt::registry& reg = inQuestECS ? sQuestECS : mECS;
+    mNodeIndex.erase(nodeId);
+    mNodeLayouts.erase(nodeId);
+    UnindexPins(entityID, inQuestECS);
+    reg.destroy(entityID);
+    if (mEditBefore && mEditBefore->GetID() == nodeId)
+        mEditBefore.reset();
+}
+
+void Character::RestoreLink(const Link& link)
+{
+    const auto entityID = mECS.create();
+    mECS.emplace<Link>(entityID, link);
+    IndexLink(entityID);
+}
+
+void Character::RemoveLink(ed::LinkId linkId)
+{
+    auto view = mECS.view<Link>();
+    for (auto&& [entityID, link] : view.each())
     {
-        auto view = mECS.view<Pin>();
-        for (auto&& [entityID, pin] : view.each())
-            if (pin.ID == pinId)
-                return entityID;
-    }
-    
-    {
-        auto view = mECS.view<InputOutput>();
-        for (auto&& [entityID, node] : view.each())
-            if (node.Input.ID == pinId || node.Output.ID == pinId)
-                return entityID;
-    }
-    
-    {
-        auto view = mECS.view<ForkInputOutput>();
-        for (auto&& [entityID, node] : view.each())
-            if (node.Input.ID == pinId ||
-                node.Outputs[0].ID == pinId ||
-                node.Outputs[1].ID == pinId
-            )
-                return entityID;
-    }
-    
-    {
-        auto view = mECS.view<InputOutputs>();
-        for (auto&& [entityID, node] : view.each())
+        if (link.ID == linkId)
         {
-            if (node.Input.ID == pinId)
-                return entityID;
-
-            for (const auto& pin : node.Outputs)
-                if (pin.ID == pinId)
-                    return entityID;
+            UnindexLink(entityID);
+            mECS.erase<Link>(entityID);
+            break;
         }
     }
+}
+
+bool Character::Undo(void)
+{
+    mEditBefore.reset();
+    if (!mHistory.Undo(*this))
+        return false;
+    ValidateIndices();
+    MarkDirty();
+    return true;
+}
+
+bool Character::Redo(void)
+{
+    mEditBefore.reset();
+    if (!mHistory.Redo(*this))
+        return false;
+    ValidateIndices();
+    MarkDirty();
+    return true;
+}
 
+void Character::TrackEdit(ed::NodeId nodeId)
+{
+    ImGuiContext& g = *GImGui;
+    const ImGuiID itemId = ImGui::GetItemID();
+    if (ImGui::IsItemActivated())
     {
-        auto view = sQuestECS.view<InputOutput>();
-        for (auto&& [entityID, node] : view.each())
-            if (node.Input.ID == pinId || node.Output.ID == pinId)
-                return entityID;
+        // The item released on this frame may only be drawn later, its edit is recorded first
+        if (mEditBefore && mEditItem == g.ActiveIdPreviousFrame && g.ActiveIdPreviousFrameHasBeenEditedBefore)
+            RecordEdit(std::move(mEditBefore));
+        mEditBefore = CaptureNode(nodeId);
+        mEditItem = itemId;
+    }
+    else if (mEditBefore && mEditItem == itemId && ImGui::IsItemDeactivated())
+    {
+        if (ImGui::IsItemDeactivatedAfterEdit())
+            RecordEdit(std::move(mEditBefore));
+        mEditBefore.reset();
     }
-    
-    return entt::null;
 }
 
-[[nodiscard]] int32_t Character::GetEntryNodeID(void)
+void Character::RecordEdit(std::optional<NodeSnapshot> before)
 {
-    auto view = mECS.view<Node>();
-    for (auto&& [entityID, node] : view.each())
-        return static_cast<int32_t>((u64)node.ID.AsPointer());
-    return 0;
+    if (!before)
+        return;
+    if (auto after = CaptureNode(before->GetID()))
+        mHistory.Push(std::make_unique<EditNodeAction>(std::move(*before), std::move(*after)));
 }
 
-
-[[nodiscard]] entt::entity Character::FindEntity(ed::NodeId nodeId) const
+void Character::TrackMoves(void)
 {
-    if (auto entityID = SearchEntity<Node>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<VariableNode<bool>>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<VariableNode<int32_t>>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<ActNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<ForkNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<BranchNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<DialogueNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<FlavorMatchNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<FlavorCheckNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<DiceNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<CommentNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<AcceptQuestNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<ReturnQuestNode>(nodeId); entityID != entt::null)
-        return entityID;
-    if (auto entityID = SearchEntity<ObjectiveNode>(nodeId); entityID != entt::null)
-        return entityID;
-    return entt::null;
+    // A click may start dragging the selected nodes, or select the node it's about to drag,
+    // either way the positions are kept before anything moves
+    if (ImGui::IsMouseClicked(0) || ed::HasSelectionChanged())
+    {
+        std::vector<ed::NodeId> selection(static_cast<size_t>(ed::GetSelectedObjectCount()));
+        selection.resize(static_cast<size_t>(ed::GetSelectedNodes(selection.data(), static_cast<int>(selection.size()))));
+        mMoveStart.clear();
+        for (const auto nodeId : selection)
+            mMoveStart.push_back({ nodeId, ed::GetNodePosition(nodeId), {} });
+    }
+
+    if (!ImGui::IsMouseReleased(0) || mMoveStart.empty())
+        return;
+
+    std::vector<MoveNodesAction::Move> moves;
+    for (auto& move : mMoveStart)
+    {
+        move.To = ed::GetNodePosition(move.ID);
+        if (move.To.x != move.From.x || move.To.y != move.From.y)
+            moves.push_back(move);
+        move.From = move.To;
+    }
+    if (!moves.empty())
+        mHistory.Push(std::make_unique<MoveNodesAction>(std::move(moves)));
 }
 
 void Character::HandleInput(void)
@@ -1284,7 +1809,7 @@ void Character::HandleInput(void)
             endPinId = mECS.get<InputOutputs>(entityID).Input.ID;
         }
         if (ImGui::MenuItem("Comment"))
-            SpawnCommentNode();
+            entityID = SpawnCommentNode();
         if (ImGui::BeginMenu("Set variable"))
         {
             if (ImGui::MenuItem("Boolean"))
@@ -1343,16 +1868,23 @@ void Character::HandleInput(void)
         }
         if (entityID != entt::null)
         {
+            MarkDirty();
             mCreateNewNode = false;
             auto* node = FindNodes(AnyNode{}, entityID);
             ed::SetNodePosition(node->ID, newNodePostion);
+            mHistory.BeginGroup();
+            if (auto snapshot = CaptureNode(node->ID))
+                mHistory.Push(std::make_unique<SpawnNodeAction>(std::move(*snapshot)));
 
-            if (auto startPin = mNewNodeLinkPin)
+            if (auto startPin = mNewNodeLinkPin; startPin && endPinId != INVALID_PIN_ID)
             {
                 auto linkEntityID = mECS.create();
+                ed::PinId startPinId = startPin->ID;
                 if (startPin->Kind == PinKind::Input)
-                    std::swap(startPin->ID, endPinId);
-                auto& link = mECS.emplace<Link>(linkEntityID, GetNextID(), startPin->ID, endPinId);
+                    std::swap(startPinId, endPinId);
+                auto& link = mECS.emplace<Link>(linkEntityID, GetNextID(), startPinId, endPinId);
+                IndexLink(linkEntityID);
+                mHistory.Push(std::make_unique<CreateLinkAction>(link));
                 
                 //for (auto& pin : pins)
                 //{
@@ -1370,6 +1902,7 @@ void Character::HandleInput(void)
                 //    }
                 //}
             }
+            mHistory.EndGroup();
         }
 
         ImGui::EndPopup();
@@ -1379,6 +1912,15 @@ void Character::HandleInput(void)
     ImGui::PopStyleVar();
     ed::Resume();
 #endif
+
+    TrackMoves();
+
+    // Node fields, drags and moves are all ImGui items. Not every interaction edits the Character,
+    // the autosave drops those that didn't by comparing what it serializes
+    const bool editing = ImGui::IsAnyItemActive();
+    if (editing || mWasEditing)
+        MarkDirty();
+    mWasEditing = editing;
 }
 
 void Character::SetupVariables(StateMachine& stateMachine) const
@@ -1398,50 +1940,26 @@ void Character::SetupVariables(StateMachine& stateMachine) const
     {
         auto view = mECS.view<ForkNode>();
         for (auto&& [entityID, node] : view.each())
-            stateMachine.SetFork(node.UUID.str(), false);
+            (void)stateMachine.InternFork(node.UUID);
     }
 }
 
-[[nodiscard]] NodeType Character::FindNodeType(entt::entity entityID)
+Character::Character(void)
+    : Character(sNextID++)
 {
-    if (auto* nodeptr = mECS.try_get<Node>(entityID))
-        return NodeType::Entry;
-    else if (auto* nodeptr = mECS.try_get<VariableNode<bool>>(entityID))
-        return NodeType::BoolVariable;
-    else if (auto* nodeptr = mECS.try_get<VariableNode<int32_t>>(entityID))
-        return NodeType::IntVariable;
-    else if (auto* nodeptr = mECS.try_get<ActNode>(entityID))
-        return NodeType::Act;
-    else if (auto* nodeptr = mECS.try_get<ForkNode>(entityID))
-        return NodeType::Fork;
-    else if (auto* nodeptr = mECS.try_get<BranchNode>(entityID))
-        return NodeType::Branch;
-    else if (auto* nodeptr = mECS.try_get<FlavorCheckNode>(entityID))
-        return NodeType::FlavorCheck;
-    else if (auto* nodeptr = mECS.try_get<FlavorMatchNode>(entityID))
-        return NodeType::FlavorMatch;
-    else if (auto* nodeptr = mECS.try_get<DialogueNode>(entityID))
-        return NodeType::Dialogue;
-    else if (auto* nodeptr = mECS.try_get<DiceNode>(entityID))
-        return NodeType::Dice;
-    else if (auto* nodeptr = sQuestECS.try_get<AcceptQuestNode>(entityID))
-        return NodeType::AcceptQuest;
-    else if (auto* nodeptr = mECS.try_get<ReturnQuestNode>(entityID))
-        return NodeType::ReturnQuest;
-    else if (auto* nodeptr = mECS.try_get<ObjectiveNode>(entityID))
-        return NodeType::Objective;
-    return NodeType::None;
+    if (ed::GetCurrentEditor())//Headless Scenes have no editor
+        for (auto&& [entityID, node] : mECS.view<Node>().each())
+            ed::SetNodePosition(node.ID, { 50.0f, 50.0f });
 }
 
-Character::Character(void)
+Character::Character(size_t id)
+    : mID(id)
 {
-    sHeaderBackground = Application_LoadTexture("Data/BlueprintBackground.png");
-    
     auto entityID = mECS.create();
     mECS.emplace<Pin>(entityID, GetNextID(), "", PinKind::Output);
     const auto& node = mECS.emplace<Node>(entityID, GetNextID());
-    ed::SetNodePosition(node.ID, { 50.0f, 50.0f });
-    mID = sNextID++;
+    IndexNode(node, entityID);
+    IndexPins(entityID);
 }
 
 void Character::RenderCreatePanel(void) noexcept
@@ -1517,6 +2035,9 @@ void Character::RenderCreatePanel(void) noexcept
                         auto& link = mECS.emplace<Link>(entityID, GetNextID());
                         link.StartPinID = startPinId;
                         link.EndPinID = endPinId;
+                        IndexLink(entityID);
+                        mHistory.Push(std::make_unique<CreateLinkAction>(link));
+                        MarkDirty();
                     }
                 }
             }
@@ -1525,37 +2046,7 @@ void Character::RenderCreatePanel(void) noexcept
         ed::PinId pinId = INVALID_PIN_ID;
         if (ed::QueryNewNode(&pinId))
         {
-            auto entityID = FindEntity(pinId);
-            Pin* pin = nullptr;
-
-            if (auto* output = mECS.try_get<Pin>(entityID))
-                if (output->ID == pinId)
-                    pin = output;
-            if (auto* pins = mECS.try_get<InputOutput>(entityID))
-            {
-                if (pins->Input.ID == pinId)
-                    pin = &pins->Input;
-                else if (pins->Output.ID == pinId)
-                    pin = &pins->Output;
-            }
-            else if (auto* pins = mECS.try_get<ForkInputOutput>(entityID))
-            {
-                if (pins->Input.ID == pinId)
-                    pin = &pins->Input;
-                else if (pins->Outputs[0].ID == pinId)
-                    pin = &pins->Outputs[0];
-                else if (pins->Outputs[1].ID == pinId)
-                    pin = &pins->Outputs[1];
-            }
-            else if (auto* pins = mECS.try_get<InputOutputs>(entityID))
-            {
-                if (pins->Input.ID == pinId)
-                    pin = &pins->Input;
-                for (auto& output : pins->Outputs)
-                    if (output.ID == pinId)
-                        pin = &output;
-            }
-            mNewLinkPin = pin;
+            mNewLinkPin = LookupPin(pinId);
             if (mNewLinkPin)
                 showLabel("+ Create Node", ImColor(32, 45, 32, 180));
 
@@ -1575,6 +2066,8 @@ void Character::RenderCreatePanel(void) noexcept
         mNewLinkPin = nullptr;
     ed::EndCreate();
 
+    // Deleting nodes deletes their links too, all of it is undone in one step
+    mHistory.BeginGroup();
     if (ed::BeginDelete())
     {
         ed::LinkId linkId = 0;
@@ -1583,14 +2076,11 @@ void Character::RenderCreatePanel(void) noexcept
         {
             if (ed::AcceptDeletedItem())
             {
-                auto view = mECS.view<Link>();
-                for (auto&& [entityID, link] : view.each())
+                if (const auto* link = FindLink(linkId))
                 {
-                    if (link.ID == linkId)
-                    {
-                        mECS.erase<Link>(entityID);
-                        break;
-                    }
+                    mHistory.Push(std::make_unique<DeleteLinkAction>(*link));
+                    RemoveLink(linkId);
+                    MarkDirty();
                 }
             }
         }
@@ -1600,42 +2090,20 @@ void Character::RenderCreatePanel(void) noexcept
         {
             if (ed::AcceptDeletedItem())
             {
-                auto deleteNode = [this, nodeId] (auto view) {
-                    for (auto&& [entityID, node] : view.each())
-                    {
-                        if (node.ID == nodeId)
-                        {
-                            mECS.destroy(entityID);
-                            break;
-                        }
-                    }
-                };
-                deleteNode(mECS.view<VariableNode<bool>>());
-                deleteNode(mECS.view<VariableNode<int32_t>>());
-                deleteNode(mECS.view<ActNode>());
-                deleteNode(mECS.view<ForkNode>());
-                deleteNode(mECS.view<BranchNode>());
-                deleteNode(mECS.view<DialogueNode>());
-                deleteNode(mECS.view<FlavorCheckNode>());
-                deleteNode(mECS.view<FlavorMatchNode>());
-                deleteNode(mECS.view<DiceNode>());
-                deleteNode(mECS.view<CommentNode>());
-                deleteNode(mECS.view<ReturnQuestNode>());
-                deleteNode(mECS.view<ObjectiveNode>());
-                auto view = sQuestECS.view<AcceptQuestNode>();
-                for (auto&& [entityID, node] : view.each())
+                // The entry node can't be captured, it stays
+                if (auto snapshot = CaptureNode(nodeId))
                 {
-                    if (node.ID == nodeId)
-                    {
-                        sQuestECS.destroy(entityID);
-                        break;
-                    }
+                    mHistory.Push(std::make_unique<DeleteNodeAction>(std::move(*snapshot)));
+                    RemoveNode(nodeId);
+                    MarkDirty();
                 }
-                
             }
         }
     }
     ed::EndDelete();
+    mHistory.EndGroup();
+
+    ValidateIndices();
 }
 
 void Character::RenderLinks(void)
@@ -1652,223 +2120,6 @@ void Character::RenderFlow(void)
         ed::Flow(link.ID);
 }
 
-[[nodiscard]] std::pair<Node*, NodeType> Character::FindNextNode(int32_t id, StateMachine& state, std::pair<Flavor, Flavor> flavors, int32_t choice)
-{
-    auto curr = FindEntity(Node{id}.ID);
-    if (curr == entt::null)
-        return { nullptr, NodeType::None };
-
-    NodeType type = FindNodeType(curr);
-    Node* node = FindNodes(AnyNode{}, curr);
-    switch (type)
-    {
-    case NodeType::Entry:
-    {
-        const auto& output = mECS.get<Pin>(curr);
-        auto* link = FindLink(output.ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::Fork:
-    {
-        const auto& pins = mECS.get<ForkInputOutput>(curr);
-        const auto key = ((ForkNode*)node)->UUID.str();
-        auto* link = FindLink(!state.Exists(key) ? pins.Outputs[1].ID : pins.Outputs[0].ID);
-        state.SetValue(key, true);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::BoolVariable:
-    case NodeType::IntVariable:
-    {
-        const auto& pins = mECS.get<InputOutput>(curr);
-        
-        if (type == NodeType::BoolVariable)
-        {
-            auto* varNode = (VariableNode<bool>*)node;
-            state.SetValue(varNode->VariableName, varNode->Value);
-        }
-        else
-        {
-            auto* varNode = (VariableNode<int32_t>*)node;
-            auto val = state.GetIntValue(varNode->VariableName);
-            switch (varNode->Operator)
-            {
-            case SetOperator::Assignment:   val  = varNode->Value;  break;
-            case SetOperator::Add:          val += varNode->Value;  break;
-            case SetOperator::Subtract:     val -= varNode->Value;  break;
-            case SetOperator::Multiple:     val *= varNode->Value;  break;
-            case SetOperator::Divide:       val /= varNode->Value;  break;
-            default:                                                break;
-            }
-            state.SetValue(varNode->VariableName, val);
-        }
-
-        auto* link = FindLink(pins.Output.ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::Branch:
-    {
-        const auto& pins = mECS.get<InputOutputs>(curr);
-        auto* branchNode = (BranchNode*)node;
-        int32_t i;
-        for (i = 0; i < branchNode->Expressions.size(); i++)
-        {
-            auto& expression = branchNode->Expressions[i];
-            bool expressionResult = true;
-            for (const auto& condition : expression)
-            {
-                if (state.Exists(condition.VariableName))//Check for bool
-                {
-                    int32_t val = state.GetBoolValue(condition.VariableName);
-                    if (val != condition.Value)//Don't need to switch on operator
-                    {
-                        expressionResult = false;
-                        break;
-                    }
-                }
-                else
-                {
-                    int32_t val = state.GetIntValue(condition.VariableName);
-                    bool result;
-                    switch (condition.Operator)
-                    {
-                    case CompareOperator::Equality:         result = val == condition.Value; break;
-                    case CompareOperator::Different:        result = val != condition.Value; break;
-                    case CompareOperator::Less:             result = val < condition.Value; break;
-                    case CompareOperator::Greater:          result = val > condition.Value; break;
-                    case CompareOperator::LessEquals:       result = val <= condition.Value; break;
-                    case CompareOperator::GreaterEquals:    result = val >= condition.Value; break;
-                    default:                                result = false; break;
-                    }
-                    if (!result)
-                    {
-                        expressionResult = false;
-                        break;
-                    }
-                }
-            }
-            if (expressionResult)
-                break;
-        }
-        auto* link = FindLink(pins.Outputs[i].ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::Dialogue:
-    {
-        const auto& pins = mECS.get<InputOutputs>(curr);
-        auto* link = FindLink(pins.Outputs[choice].ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::Act:
-    {
-        const auto& pins = mECS.get<InputOutput>(curr);
-        auto* link = FindLink(pins.Output.ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::FlavorMatch:
-    {
-        const auto& pins = mECS.get<ForkInputOutput>(curr);
-        auto&& [mainFlavor, npcFlavor] = flavors;
-        auto& pin = pins.Outputs[IsFlavorMatching(mainFlavor, npcFlavor) ? 0 : 1];
-        auto* link = FindLink(pin.ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::FlavorCheck:
-    {
-        const auto& pins = mECS.get<InputOutputs>(curr);
-        const auto& node = mECS.get<FlavorCheckNode>(curr);
-        const auto [mainFlavor, npcFlavor] = flavors;
-        const auto flavor = node.CheckingNPC ? npcFlavor : mainFlavor;
-        const size_t index = static_cast<size_t>(flavor);
-        if (index > 4)
-            return { nullptr, NodeType::None };
-        auto* link = FindLink(pins.Outputs[index].ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    case NodeType::Dice:
-    {
-        const auto& pins = mECS.get<InputOutputs>(curr);
-        const float index = pins.Outputs.size() * Random::Float();
-        auto* link = FindLink(pins.Outputs[static_cast<int32_t>(index)].ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-        break;
-    }
-    case NodeType::AcceptQuest:
-    case NodeType::ReturnQuest:
-    case NodeType::Objective:
-    {
-        entt::registry& reg = type == NodeType::AcceptQuest ? Character::sQuestECS : mECS;
-        const auto& pins = reg.get<InputOutput>(curr);
-        auto* link = FindLink(pins.Output.ID);
-        if (link == nullptr)
-            return { nullptr, NodeType::None };
-        auto next = FindEntity(link->EndPinID);
-        return { FindNodes(AnyNode{}, next), FindNodeType(next) };
-    }
-    default:
-        break;
-    }
-
-    return { nullptr, NodeType::None };
-}
-
-static bool IsFlavorMatching(Flavor lhs, Flavor rhs)
-{
-    if (lhs == rhs)
-        return true;
-    else if (lhs == Flavor::Bitter &&
-        (rhs == Flavor::BitterSalty || rhs == Flavor::BitterSweet || rhs == Flavor::BitterSour))
-        return true;
-    else if (lhs == Flavor::Salty &&
-        (rhs == Flavor::SaltySour || rhs == Flavor::SaltySweet))
-        return true;
-    else if (rhs == Flavor::Bitter &&
-        (lhs == Flavor::BitterSalty || lhs == Flavor::BitterSweet || lhs == Flavor::BitterSour))
-        return true;
-    else if (rhs == Flavor::Salty &&
-        (lhs == Flavor::SaltySour || lhs == Flavor::SaltySweet))
-        return true;
-    else if (lhs == Flavor::Sour &&
-        (rhs == Flavor::BitterSour || rhs == Flavor::SaltySour || rhs == Flavor::SweetSour))
-        return true;
-    else if (rhs == Flavor::Sour &&
-        (lhs == Flavor::BitterSour || lhs == Flavor::SaltySour || lhs == Flavor::SweetSour))
-        return true;
-    else if ((lhs == Flavor::Sweet || lhs == Flavor::Sour) && rhs == Flavor::SweetSour)
-        return true;
-    else if ((rhs == Flavor::Sweet || rhs == Flavor::Sour) && lhs == Flavor::SweetSour)
-        return true;
-    else
-        return false;
-}
-
 static bool IsFlavorSame(Flavor lhs, Flavor rhs) { return lhs == rhs; }
 
 static void AddNewLines(char* text, size_t N)
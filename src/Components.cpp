@@ -27,4 +27,34 @@ YAML::Emitter& operator<<(YAML::Emitter& emitter, const ImVec2& vec) noexcept
 	emitter << vec.x << vec.y;
 	emitter << YAML::EndSeq;
 	return emitter;
-}
\ No newline at end of file
+}
+
+bool IsFlavorMatching(Flavor lhs, Flavor rhs)
+{
+	if (lhs == rhs)
+		return true;
+	else if (lhs == Flavor::Bitter &&
+		(rhs == Flavor::BitterSalty || rhs == Flavor::BitterSweet || rhs == Flavor::BitterSour))
+		return true;
+	else if (lhs == Flavor::Salty &&
+		(rhs == Flavor::SaltySour || rhs == Flavor::SaltySweet))
+		return true;
+	else if (rhs == Flavor::Bitter &&
+		(lhs == Flavor::BitterSalty || lhs == Flavor::BitterSweet || lhs == Flavor::BitterSour))
+		return true;
+	else if (rhs == Flavor::Salty &&
+		(lhs == Flavor::SaltySour || lhs == Flavor::SaltySweet))
+		return true;
+	else if (lhs == Flavor::Sour &&
+		(rhs == Flavor::BitterSour || rhs == Flavor::SaltySour || rhs == Flavor::SweetSour))
+		return true;
+	else if (rhs == Flavor::Sour &&
+		(lhs == Flavor::BitterSour || lhs == Flavor::SaltySour || lhs == Flavor::SweetSour))
+		return true;
+	else if ((lhs == Flavor::Sweet || lhs == Flavor::Sour) && rhs == Flavor::SweetSour)
+		return true;
+	else if ((rhs == Flavor::Sweet || rhs == Flavor::Sour) && lhs == Flavor::SweetSour)
+		return true;
+	else
+		return false;
+}
@@ -0,0 +1,258 @@
+#include <DialogueProgram.h>
+#include <Character.h>
+
+#include <algorithm>
+
+DialogueProgram::DialogueProgram(const Character& character, StateMachine& state)
+{
+	const auto& reg = character.mECS;
+	std::unordered_map<ed::PinId, uint32_t, IdHash<ed::PinId>> entries;
+	std::vector<ed::PinId> pendingOutputs;
+
+	auto emit = [this, &entries, &pendingOutputs](NodeType op, const Node& node, const Pin* input, std::span<const Pin> outputs) -> Instruction& {
+		const uint32_t pc = static_cast<uint32_t>(mInstructions.size());
+		if (input)
+			entries[input->ID] = pc;
+
+		auto& instruction = mInstructions.emplace_back();
+		instruction.Op = op;
+		instruction.NodeID = static_cast<int32_t>(node.ID.Get());
+		instruction.FirstSuccessor = static_cast<uint32_t>(pendingOutputs.size());
+		instruction.SuccessorCount = static_cast<uint32_t>(outputs.size());
+		for (const auto& output : outputs)
+			pendingOutputs.emplace_back(output.ID);
+		return instruction;
+	};
+
+	for (auto&& [entityID, node, output] : reg.view<Node, Pin>().each())
+	{
+		if (mEntry == END)
+			mEntry = static_cast<uint32_t>(mInstructions.size());
+		emit(NodeType::Entry, node, nullptr, { &output, 1 });
+	}
+
+	for (auto&& [entityID, node, pins] : reg.view<VariableNode<bool>, InputOutput>().each())
+	{
+		auto& instruction = emit(NodeType::BoolVariable, node, &pins.Input, { &pins.Output, 1 });
+		instruction.Variable = state.Intern(node.VariableName);
+		instruction.Operator = node.Operator;
+		instruction.Value = node.Value;
+	}
+
+	for (auto&& [entityID, node, pins] : reg.view<VariableNode<int32_t>, InputOutput>().each())
+	{
+		auto& instruction = emit(NodeType::IntVariable, node, &pins.Input, { &pins.Output, 1 });
+		instruction.Variable = state.Intern(node.VariableName);
+		instruction.Operator = node.Operator;
+		instruction.Value = node.Value;
+	}
+
+	for (auto&& [entityID, node, pins] : reg.view<ActNode, InputOutput>().each())
+	{
+		auto& instruction = emit(NodeType::Act, node, &pins.Input, { &pins.Output, 1 });
+		instruction.FirstOperand = static_cast<uint32_t>(mBubbles.size());
+		instruction.OperandCount = static_cast<uint32_t>(node.Bubbles.size());
+		mBubbles.insert(mBubbles.end(), node.Bubbles.begin(), node.Bubbles.end());
+	}
+
+	for (auto&& [entityID, node, pins] : reg.view<ForkNode, ForkInputOutput>().each())
+	{
+		auto& instruction = emit(NodeType::Fork, node, &pins.Input, pins.Outputs);
+		instruction.Variable = state.InternFork(node.UUID);
+	}
+
+	for (auto&& [entityID, node, pins] : reg.view<BranchNode, InputOutputs>().each())
+	{
+		auto& instruction = emit(NodeType::Branch, node, &pins.Input, pins.Outputs);
+		instruction.FirstOperand = static_cast<uint32_t>(mExpressions.size());
+		instruction.OperandCount = static_cast<uint32_t>(node.Expressions.size());
+		for (const auto& expression : node.Expressions)
+		{
+			mExpressions.push_back({ static_cast<uint32_t>(mConditions.size()), static_cast<uint32_t>(expression.size()) });
+			for (const auto& condition : expression)
+				mConditions.push_back({ state.Intern(condition.VariableName), condition.Operator, condition.Value });
+		}
+	}
+
+	for (auto&& [entityID, node, pins] : reg.view<DialogueNode, InputOutputs>().each())
+	{
+		auto& instruction = emit(NodeType::Dialogue, node, &pins.Input, pins.Outputs);
+		instruction.FirstOperand = static_cast<uint32_t>(mPrompts.size());
+		instruction.OperandCount = static_cast<uint32_t>(node.Prompts.size());
+		mPrompts.insert(mPrompts.end(), node.Prompts.begin(), node.Prompts.end());
+	}
+
+	for (auto&& [entityID, node, pins] : reg.view<FlavorMatchNode, ForkInputOutput>().each())
+		emit(NodeType::FlavorMatch, node, &pins.Input, pins.Outputs);
+
+	for (auto&& [entityID, node, pins] : reg.view<FlavorCheckNode, InputOutputs>().each())
+		emit(NodeType::FlavorCheck, node, &pins.Input, pins.Outputs).CheckingNPC = node.CheckingNPC;
+
+	for (auto&& [entityID, node, pins] : reg.view<DiceNode, InputOutputs>().each())
+		emit(NodeType::Dice, node, &pins.Input, pins.Outputs);
+
+	for (auto&& [entityID, node, pins] : reg.view<ReturnQuestNode, InputOutput>().each())
+		emit(NodeType::ReturnQuest, node, &pins.Input, { &pins.Output, 1 });
+
+	for (auto&& [entityID, node, pins] : reg.view<ObjectiveNode, InputOutput>().each())
+		emit(NodeType::Objective, node, &pins.Input, { &pins.Output, 1 });
+
+	for (auto&& [entityID, node, pins] : Character::sQuestECS.view<AcceptQuestNode, InputOutput>().each())
+	{
+		if (node.Owner == character.mID)
+			emit(NodeType::AcceptQuest, node, &pins.Input, { &pins.Output, 1 });
+	}
+
+	// Every output becomes the index of the instruction its link leads to
+	mSuccessors.reserve(pendingOutputs.size());
+	for (const auto& pinId : pendingOutputs)
+	{
+		uint32_t successor = END;
+		if (const auto* link = character.FindLink(pinId))
+			if (auto it = entries.find(link->EndPinID); it != entries.end())
+				successor = it->second;
+		mSuccessors.emplace_back(successor);
+	}
+}
+
+[[nodiscard]] uint32_t DialogueProgram::Execute(uint32_t pc, StateMachine& state, std::pair<Flavor, Flavor> flavors, Random& random, int32_t choice) const
+{
+	if (pc >= mInstructions.size())
+		return END;
+
+	const auto& instruction = mInstructions[pc];
+	const auto [mainFlavor, npcFlavor] = flavors;
+	switch (instruction.Op)
+	{
+	case NodeType::Entry:
+	case NodeType::Act:
+	case NodeType::AcceptQuest:
+	case NodeType::ReturnQuest:
+	case NodeType::Objective:
+		return 0;
+	case NodeType::Fork:
+	{
+		const bool visited = state.IsVisited(instruction.Variable);
+		state.SetVisited(instruction.Variable, true);
+		return visited ? 0 : 1;
+	}
+	case NodeType::BoolVariable:
+		state.SetValue(instruction.Variable, instruction.Value != 0);
+		return 0;
+	case NodeType::IntVariable:
+	{
+		// Wraps around instead of overflowing, loops that keep multiplying are common enough and the Analyzer runs them on purpose
+		auto val = static_cast<uint32_t>(state.GetIntValue(instruction.Variable));
+		const auto operand = static_cast<uint32_t>(instruction.Value);
+		switch (instruction.Operator)
+		{
+		case SetOperator::Assignment:   val  = operand;  break;
+		case SetOperator::Add:          val += operand;  break;
+		case SetOperator::Subtract:     val -= operand;  break;
+		case SetOperator::Multiple:     val *= operand;  break;
+		case SetOperator::Divide:
+			// Zero leaves the variable alone (the Analyzer reports these), -1 is a negation so INT32_MIN wraps too
+			if (instruction.Value == -1)
+				val = 0u - val;
+			else if (instruction.Value != 0)
+				val = static_cast<uint32_t>(static_cast<int32_t>(val) / instruction.Value);
+			break;
+		default:                                         break;
+		}
+		state.SetValue(instruction.Variable, static_cast<int32_t>(val));
+		return 0;
+	}
+	case NodeType::Branch:
+	{
+		uint32_t i;
+		for (i = 0; i < instruction.OperandCount; i++)
+			if (Evaluate(mExpressions[instruction.FirstOperand + i], state))
+				break;
+		return i;
+	}
+	case NodeType::Dialogue:
+		return choice < 0 ? END : static_cast<uint32_t>(choice);
+	case NodeType::FlavorMatch:
+		return IsFlavorMatching(mainFlavor, npcFlavor) ? 0 : 1;
+	case NodeType::FlavorCheck:
+	{
+		const auto flavor = instruction.CheckingNPC ? npcFlavor : mainFlavor;
+		const size_t index = static_cast<size_t>(flavor);
+		return index > 4 ? END : static_cast<uint32_t>(index);
+	}
+	case NodeType::Dice:
+		return instruction.SuccessorCount == 0 ? END : random.Below(instruction.SuccessorCount);
+	default:
+		break;
+	}
+
+	return END;
+}
+
+[[nodiscard]] std::span<const std::pair<Speaker, std::string>> DialogueProgram::GetBubbles(uint32_t pc) const
+{
+	if (GetOpCode(pc) != NodeType::Act)
+		return {};
+	const auto& instruction = mInstructions[pc];
+	return { mBubbles.data() + instruction.FirstOperand, instruction.OperandCount };
+}
+
+[[nodiscard]] std::span<const std::string> DialogueProgram::GetPrompts(uint32_t pc) const
+{
+	if (GetOpCode(pc) != NodeType::Dialogue)
+		return {};
+	const auto& instruction = mInstructions[pc];
+	return { mPrompts.data() + instruction.FirstOperand, instruction.OperandCount };
+}
+
+[[nodiscard]] const char* DialogueProgram::GetOpName(NodeType op) noexcept
+{
+	switch (op)
+	{
+	case NodeType::Entry:           return "Entry";
+	case NodeType::BoolVariable:    return VariableNode<bool>::NAME;
+	case NodeType::IntVariable:     return VariableNode<int32_t>::NAME;
+	case NodeType::Act:             return ActNode::NAME;
+	case NodeType::Fork:            return ForkNode::NAME;
+	case NodeType::Branch:          return BranchNode::NAME;
+	case NodeType::Dialogue:        return DialogueNode::NAME;
+	case NodeType::FlavorMatch:     return FlavorMatchNode::NAME;
+	case NodeType::FlavorCheck:     return FlavorCheckNode::NAME;
+	case NodeType::Dice:            return DiceNode::NAME;
+	case NodeType::AcceptQuest:     return AcceptQuestNode::NAME;
+	case NodeType::ReturnQuest:     return ReturnQuestNode::NAME;
+	case NodeType::Objective:       return ObjectiveNode::NAME;
+	default:                        return "None";
+	}
+}
+
+[[nodiscard]] bool DialogueProgram::Evaluate(const CompiledExpression& expression, const StateMachine& state) const
+{
+	for (uint32_t i = 0; i < expression.ConditionCount; i++)
+	{
+		const auto& condition = mConditions[expression.FirstCondition + i];
+		if (state.Exists(condition.Variable))//Check for bool
+		{
+			int32_t val = state.GetBoolValue(condition.Variable);
+			if (val != condition.Value)//Don't need to switch on operator
+				return false;
+			continue;
+		}
+
+		int32_t val = state.GetIntValue(condition.Variable);
+		bool result;
+		switch (condition.Operator)
+		{
+		case CompareOperator::Equality:         result = val == condition.Value; break;
+		case CompareOperator::Different:        result = val != condition.Value; break;
+		case CompareOperator::Less:             result = val < condition.Value; break;
+		case CompareOperator::Greater:          result = val > condition.Value; break;
+		case CompareOperator::LessEquals:       result = val <= condition.Value; break;
+		case CompareOperator::GreaterEquals:    result = val >= condition.Value; break;
+		default:                                result = false; break;
+		}
+		if (!result)
+			return false;
+	}
+	return true;
+}
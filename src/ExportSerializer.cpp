@@ -1,9 +1,13 @@
 #include <ExportSerializer.h>
 #include <Components.h>
+#include <FileWriter.h>
 #include <Nodes.hpp>
+#include <ThreadPool.h>
 
 #include <yaml-cpp/yaml.h>
-#include <fstream>
+
+#include <algorithm>
+#include <deque>
 
 static std::string SerializeSetOperator(SetOperator pOperator);
 static std::string SerializeCompareOperator(CompareOperator pOperator);
@@ -13,419 +17,485 @@ static SetOperator DeserializeSetOperator(const std::string& pOperator);
 static CompareOperator DeserializeCompareOperator(const std::string& pOperator);
 static Speaker DeserializeSpeaker(const std::string& pSpeaker);
 
-ExportSerializer::ExportSerializer(Scene* scene)
-	: mScene(scene) {}
+ExportSerializer::ExportSerializer(Scene* scene, size_t threadCount)
+	: mScene(scene), mThreadCount(threadCount) {}
 
-void ExportSerializer::Serialize(const std::string& filepath)
+bool ExportSerializer::Serialize(const std::string& filepath)
 {
-	YAML::Emitter out;
-	out << YAML::BeginMap;
-	out << YAML::Key << "Characters" << YAML::Value;
-	out << YAML::BeginSeq;
-	for (const auto& characterData : mScene->mAllData)
+	const auto& characters = mScene->mAllData;
+	FileWriter file(filepath);
+	if (characters.empty())
 	{
+		YAML::Emitter out(file.GetStream());
+		out << YAML::BeginMap;
+		out << YAML::Key << "Characters" << YAML::Value << YAML::BeginSeq << YAML::EndSeq;
+		out << YAML::EndMap;
+		return file.Commit();
+	}
+
+	// Quests live in the calling thread's registry, the workers are handed it explicitly
+	const entt::registry& quests = Character::sQuestECS;
+	BuildQuestInputs();
+
+	// Every Character is emitted on its own as "Characters:\n  - <Character>", which is exactly how it
+	// appears in the full document, so the documents are spliced in order and the output doesn't
+	// depend on the thread count
+	auto emit = [this, &quests](const Scene::CharacterData& characterData) {
+		YAML::Emitter out;
 		out << YAML::BeginMap;
-		const auto& character = characterData.Self;
-
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Entry Node -------------------------------------
-		// ---------------------------------------------------------------------------------
-		
-		out << YAML::Key << "Name" << YAML::Value << characterData.Name;
-		out << YAML::Key << "EntryNode" << YAML::Value;
+		out << YAML::Key << "Characters" << YAML::Value;
+		out << YAML::BeginSeq;
+		SerializeCharacter(out, characterData, quests);
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+		return std::string(out.c_str(), out.size());
+	};
+
+	auto& stream = file.GetStream();
+	auto write = [&stream, &file](const std::string& document, bool first) {
+		const size_t body = first ? 0 : document.find('\n') + 1;
+		if (!first)
+			stream.put('\n');
+		stream.write(document.data() + body, document.size() - body);
+		file.Flush();
+	};
+
+	const size_t threadCount = std::min<size_t>(mThreadCount == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : mThreadCount, characters.size());
+	if (threadCount <= 1)
+	{
+		for (size_t i = 0; i < characters.size(); i++)
+			write(emit(characters[i]), i == 0);
+		return file.Commit();
+	}
+
+	// Only a window of Characters is in flight, so the pending documents stay bounded on large Scenes
+	ThreadPool pool(threadCount);
+	std::deque<std::future<std::string>> pending;
+	const size_t window = threadCount * 2;
+	size_t submitted = 0;
+	for (size_t i = 0; i < characters.size(); i++)
+	{
+		for (; submitted < characters.size() && submitted < i + window; submitted++)
+			pending.emplace_back(pool.Submit([&emit, &characterData = characters[submitted]]() { return emit(characterData); }));
+
+		write(pending.front().get(), i == 0);
+		pending.pop_front();
+	}
+	return file.Commit();
+}
+
+void ExportSerializer::SerializeCharacter(YAML::Emitter& out, const Scene::CharacterData& characterData, const entt::registry& quests) const
+{
+	out << YAML::BeginMap;
+	const auto& character = characterData.Self;
+	TargetTable targetTable;
+	BuildTargets(character, targetTable);
+
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Entry Node -------------------------------------
+	// ---------------------------------------------------------------------------------
+	
+	out << YAML::Key << "Name" << YAML::Value << characterData.Name;
+	out << YAML::Key << "EntryNode" << YAML::Value;
+	{
+		auto view = character.mECS.view<Node, Pin>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pin] : view.each())
 		{
-			auto view = character.mECS.view<Node, Pin>();
-			auto links = character.mECS.view<Link>();
-			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pin] : view.each())
-			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				auto targets = FindTargets(character.mECS, pin);
-				out << YAML::Key << "Outputs" << YAML::Value << targets;
-				out << YAML::EndMap;
-			}
-			out << YAML::EndSeq;
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			const auto& targets = FindTargets(targetTable, pin);
+			out << YAML::Key << "Outputs" << YAML::Value << targets;
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Variables Nodes --------------------------------
-		// ---------------------------------------------------------------------------------
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Variables Nodes --------------------------------
+	// ---------------------------------------------------------------------------------
 
-		out << YAML::Key << "VariableNodes" << YAML::Value;
+	out << YAML::Key << "VariableNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<VariableNode<bool>, InputOutput>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<VariableNode<bool>, InputOutput>();
-			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
-			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "Type" << YAML::Value << "Boolean";
-				out << YAML::Key << "Name" << YAML::Value << node.VariableName;
-				out << YAML::Key << "Operator" << YAML::Value << SerializeSetOperator(node.Operator);
-				out << YAML::Key << "Value" << YAML::Value << node.Value;
-				auto targets = FindTargets(character.mECS, pins.Output);
-				out << YAML::Key << "Outputs" << YAML::Value << targets;
-				out << YAML::EndMap;
-			}
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "Type" << YAML::Value << "Boolean";
+			out << YAML::Key << "Name" << YAML::Value << node.VariableName;
+			out << YAML::Key << "Operator" << YAML::Value << SerializeSetOperator(node.Operator);
+			out << YAML::Key << "Value" << YAML::Value << node.Value;
+			const auto& targets = FindTargets(targetTable, pins.Output);
+			out << YAML::Key << "Outputs" << YAML::Value << targets;
+			out << YAML::EndMap;
 		}
+	}
+	{
+		auto view = character.mECS.view<VariableNode<int32_t>, InputOutput>();
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<VariableNode<int32_t>, InputOutput>();
-			for (auto&& [entityID, node, pins] : view.each())
-			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "Type" << YAML::Value << "Integer";
-				out << YAML::Key << "Name" << YAML::Value << node.VariableName;
-				out << YAML::Key << "Operator" << YAML::Value << SerializeSetOperator(node.Operator);
-				out << YAML::Key << "Value" << YAML::Value << node.Value;
-				auto targets = FindTargets(character.mECS, pins.Output);
-				out << YAML::Key << "Outputs" << YAML::Value << targets;
-				out << YAML::EndMap;
-			}
-			out << YAML::EndSeq;
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "Type" << YAML::Value << "Integer";
+			out << YAML::Key << "Name" << YAML::Value << node.VariableName;
+			out << YAML::Key << "Operator" << YAML::Value << SerializeSetOperator(node.Operator);
+			out << YAML::Key << "Value" << YAML::Value << node.Value;
+			const auto& targets = FindTargets(targetTable, pins.Output);
+			out << YAML::Key << "Outputs" << YAML::Value << targets;
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Act Nodes --------------------------------------
-		// ---------------------------------------------------------------------------------
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Act Nodes --------------------------------------
+	// ---------------------------------------------------------------------------------
 
-		out << YAML::Key << "ActNodes" << YAML::Value;
+	out << YAML::Key << "ActNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<ActNode, InputOutput>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<ActNode, InputOutput>();
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int32_t)(u64)node.ID.AsPointer();
+			out << YAML::Key << "Title" << YAML::Value << node.Title;
+			const auto& targets = FindTargets(targetTable, pins.Output);
+			out << YAML::Key << "Outputs" << YAML::Value << targets;
+			out << YAML::Key << "Bubbles" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (auto&& [speaker, line] : node.Bubbles)
 			{
 				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int32_t)(u64)node.ID.AsPointer();
-				out << YAML::Key << "Title" << YAML::Value << node.Title;
-				auto targets = FindTargets(character.mECS, pins.Output);
-				out << YAML::Key << "Outputs" << YAML::Value << targets;
-				out << YAML::Key << "Bubbles" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (auto&& [speaker, line] : node.Bubbles)
-				{
-					out << YAML::BeginMap;
-					out << YAML::Key << "Speaker" << YAML::Value << SerializeSpeaker(speaker);
-					out << YAML::Key << "Line" << YAML::Value << line;
-					out << YAML::EndMap;
-				}
-				out << YAML::EndSeq;
+				out << YAML::Key << "Speaker" << YAML::Value << SerializeSpeaker(speaker);
+				out << YAML::Key << "Line" << YAML::Value << line;
 				out << YAML::EndMap;
 			}
 			out << YAML::EndSeq;
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Fork Nodes -------------------------------------
-		// ---------------------------------------------------------------------------------
-		
-		out << YAML::Key << "ForkNodes" << YAML::Value;
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Fork Nodes -------------------------------------
+	// ---------------------------------------------------------------------------------
+	
+	out << YAML::Key << "ForkNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<ForkNode, ForkInputOutput>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<ForkNode, ForkInputOutput>();
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "UUID" << YAML::Value << node.UUID.str();
+			
+			out << YAML::Key << "Outputs" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& output : pins.Outputs)
 			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "UUID" << YAML::Value << node.UUID.str();
-				
-				out << YAML::Key << "Outputs" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& output : pins.Outputs)
-				{
-					auto targets = FindTargets(character.mECS, output);
-					out << targets;
-				}
-				out << YAML::EndSeq;
-				
-				out << YAML::EndMap;
+				const auto& targets = FindTargets(targetTable, output);
+				out << targets;
 			}
 			out << YAML::EndSeq;
+			
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Branch Nodes -----------------------------------
-		// ---------------------------------------------------------------------------------
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Branch Nodes -----------------------------------
+	// ---------------------------------------------------------------------------------
 
-		out << YAML::Key << "BranchNodes" << YAML::Value;
+	out << YAML::Key << "BranchNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<BranchNode, InputOutputs>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<BranchNode, InputOutputs>();
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "Expressions" << YAML::Value;//a == true && b == true && ...
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& expressions : node.Expressions)
 			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "Expressions" << YAML::Value;//a == true && b == true && ...
-				out << YAML::BeginSeq;
-				for (const auto& expressions : node.Expressions)
+				out << YAML::BeginSeq << YAML::Indent(1);
+				for (const auto& condition : expressions)
 				{
-					out << YAML::BeginSeq << YAML::Indent(1);
-					for (const auto& condition : expressions)
-					{
-						out << YAML::BeginMap;
-						out << YAML::Key << "Name" << YAML::Value << condition.VariableName;
-						out << YAML::Key << "Operator" << YAML::Value << SerializeCompareOperator(condition.Operator);
-						out << YAML::Key << "Value" << YAML::Value << condition.Value;
-						out << YAML::EndMap;
-					}
-					out << YAML::EndSeq;
-				}
-				out << YAML::EndSeq;
-				
-				out << YAML::Key << "Outputs" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& output : pins.Outputs)
-				{
-					auto targets = FindTargets(character.mECS, output);
-					out << targets;
+					out << YAML::BeginMap;
+					out << YAML::Key << "Name" << YAML::Value << condition.VariableName;
+					out << YAML::Key << "Operator" << YAML::Value << SerializeCompareOperator(condition.Operator);
+					out << YAML::Key << "Value" << YAML::Value << condition.Value;
+					out << YAML::EndMap;
 				}
 				out << YAML::EndSeq;
-
-				out << YAML::EndMap;
 			}
 			out << YAML::EndSeq;
-		}
-
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Flavor Check Nodes -----------------------------
-		// ---------------------------------------------------------------------------------
-
-		out << YAML::Key << "FlavorCheckNodes" << YAML::Value;
-		{
-			auto view = character.mECS.view<FlavorCheckNode, InputOutputs>();
+			
+			out << YAML::Key << "Outputs" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& output : pins.Outputs)
 			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "ForNpc" << YAML::Value << node.CheckingNPC;
-				
-				out << YAML::Key << "Outputs" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& output : pins.Outputs)
-				{
-					auto targets = FindTargets(character.mECS, output);
-					out << targets;
-				}
-				out << YAML::EndSeq;
-
-				out << YAML::EndMap;
+				const auto& targets = FindTargets(targetTable, output);
+				out << targets;
 			}
 			out << YAML::EndSeq;
+
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
+
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Flavor Check Nodes -----------------------------
+	// ---------------------------------------------------------------------------------
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Flavor Match Nodes -----------------------------
-		// ---------------------------------------------------------------------------------
-		
-		out << YAML::Key << "FlavorMatchNodes" << YAML::Value;
+	out << YAML::Key << "FlavorCheckNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<FlavorCheckNode, InputOutputs>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<FlavorMatchNode, ForkInputOutput>();
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "ForNpc" << YAML::Value << node.CheckingNPC;
+			
+			out << YAML::Key << "Outputs" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& output : pins.Outputs)
 			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				
-				out << YAML::Key << "Outputs" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& output : pins.Outputs)
-				{
-					auto targets = FindTargets(character.mECS, output);
-					out << targets;
-				}
-				out << YAML::EndSeq;
-
-				out << YAML::EndMap;
+				const auto& targets = FindTargets(targetTable, output);
+				out << targets;
 			}
 			out << YAML::EndSeq;
+
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Dialogue Nodes ---------------------------------
-		// ---------------------------------------------------------------------------------
-		out << YAML::Key << "DialogueNodes" << YAML::Value;
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Flavor Match Nodes -----------------------------
+	// ---------------------------------------------------------------------------------
+	
+	out << YAML::Key << "FlavorMatchNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<FlavorMatchNode, ForkInputOutput>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<DialogueNode, InputOutputs>();
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			
+			out << YAML::Key << "Outputs" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& output : pins.Outputs)
 			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "Prompts" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& prompt : node.Prompts)
-					out << prompt;
-				out << YAML::EndSeq;
-				
-				out << YAML::Key << "Outputs" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& output : pins.Outputs)
-				{
-					auto targets = FindTargets(character.mECS, output);
-					out << targets;
-				}
-				out << YAML::EndSeq;
-
-				out << YAML::EndMap;
+				const auto& targets = FindTargets(targetTable, output);
+				out << targets;
 			}
 			out << YAML::EndSeq;
+
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Accept Quest Nodes -----------------------------
-		// ---------------------------------------------------------------------------------
-		out << YAML::Key << "AcceptQuestNodes" << YAML::Value;
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Dialogue Nodes ---------------------------------
+	// ---------------------------------------------------------------------------------
+	out << YAML::Key << "DialogueNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<DialogueNode, InputOutputs>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = Character::sQuestECS.view<AcceptQuestNode, InputOutput>();
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "Prompts" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& prompt : node.Prompts)
+				out << prompt;
+			out << YAML::EndSeq;
+			
+			out << YAML::Key << "Outputs" << YAML::Value;
+			out << YAML::BeginSeq;
+			for (const auto& output : pins.Outputs)
 			{
-				if (node.Owner != character.mID)
-					continue;
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "UUID" << YAML::Value << node.UUID.str();
-				out << YAML::Key << "Title" << YAML::Value << node.Title;
-				out << YAML::Key << "Description" << YAML::Value << node.Description;
-				out << YAML::Key << "Objectives" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& objective : node.Objectives)
-				{
-					out << YAML::BeginMap;
-					out << YAML::Key << "UUID" << YAML::Value << objective.UUID.str();
-					out << YAML::Key << "Title" << YAML::Value << objective.Title;
-					out << YAML::Key << "Description" << YAML::Value << objective.Description;
-					out << YAML::Key << "IsOptional" << YAML::Value << objective.IsOptional;
-					out << YAML::EndMap;
-				}
-				out << YAML::EndSeq;
-				out << YAML::Key << "Outputs" << YAML::Value << FindTargets(character.mECS, pins.Output);
-				out << YAML::EndMap;
+				const auto& targets = FindTargets(targetTable, output);
+				out << targets;
 			}
 			out << YAML::EndSeq;
+
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Return Quest Nodes -----------------------------
-		// ---------------------------------------------------------------------------------
-		out << YAML::Key << "ReturnQuestNodes" << YAML::Value;
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Accept Quest Nodes -----------------------------
+	// ---------------------------------------------------------------------------------
+	out << YAML::Key << "AcceptQuestNodes" << YAML::Value;
+	{
+		auto view = quests.view<AcceptQuestNode, InputOutput>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<ReturnQuestNode, InputOutput>();
+			if (node.Owner != character.mID)
+				continue;
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "UUID" << YAML::Value << node.UUID.str();
+			out << YAML::Key << "Title" << YAML::Value << node.Title;
+			out << YAML::Key << "Description" << YAML::Value << node.Description;
+			out << YAML::Key << "Objectives" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& objective : node.Objectives)
 			{
 				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "QuestID" << YAML::Value << node.QuestID.str();
-				out << YAML::Key << "Succeed" << YAML::Value << node.Succeed;
-				out << YAML::Key << "Outputs" << YAML::Value << FindTargets(character.mECS, pins.Output);
+				out << YAML::Key << "UUID" << YAML::Value << objective.UUID.str();
+				out << YAML::Key << "Title" << YAML::Value << objective.Title;
+				out << YAML::Key << "Description" << YAML::Value << objective.Description;
+				out << YAML::Key << "IsOptional" << YAML::Value << objective.IsOptional;
 				out << YAML::EndMap;
 			}
 			out << YAML::EndSeq;
+			out << YAML::Key << "Outputs" << YAML::Value << FindTargets(targetTable, pins.Output);
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Objective Nodes --------------------------------
-		// ---------------------------------------------------------------------------------
-		out << YAML::Key << "ObjectiveNodes" << YAML::Value;
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Return Quest Nodes -----------------------------
+	// ---------------------------------------------------------------------------------
+	out << YAML::Key << "ReturnQuestNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<ReturnQuestNode, InputOutput>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<ObjectiveNode, InputOutput>();
-			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
-			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "QuestID" << YAML::Value << node.QuestID.str();
-				out << YAML::Key << "ObjectiveID" << YAML::Value << node.ObjectiveID.str();
-				out << YAML::Key << "Succeed" << YAML::Value << node.Succeed;
-				out << YAML::Key << "Outputs" << YAML::Value << FindTargets(character.mECS, pins.Output);
-				out << YAML::EndMap;
-			}
-			out << YAML::EndSeq;
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "QuestID" << YAML::Value << node.QuestID.str();
+			out << YAML::Key << "Succeed" << YAML::Value << node.Succeed;
+			out << YAML::Key << "Outputs" << YAML::Value << FindTargets(targetTable, pins.Output);
+			out << YAML::EndMap;
+		}
+		out << YAML::EndSeq;
+	}
+
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Objective Nodes --------------------------------
+	// ---------------------------------------------------------------------------------
+	out << YAML::Key << "ObjectiveNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<ObjectiveNode, InputOutput>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
+		{
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "QuestID" << YAML::Value << node.QuestID.str();
+			out << YAML::Key << "ObjectiveID" << YAML::Value << node.ObjectiveID.str();
+			out << YAML::Key << "Succeed" << YAML::Value << node.Succeed;
+			out << YAML::Key << "Outputs" << YAML::Value << FindTargets(targetTable, pins.Output);
+			out << YAML::EndMap;
 		}
+		out << YAML::EndSeq;
+	}
 
-		// ---------------------------------------------------------------------------------
-		// -------------------------------- Dice Nodes -------------------------------------
-		// ---------------------------------------------------------------------------------
-		out << YAML::Key << "DiceNodes" << YAML::Value;
+	// ---------------------------------------------------------------------------------
+	// -------------------------------- Dice Nodes -------------------------------------
+	// ---------------------------------------------------------------------------------
+	out << YAML::Key << "DiceNodes" << YAML::Value;
+	{
+		auto view = character.mECS.view<DiceNode, InputOutputs>();
+		out << YAML::BeginSeq;
+		for (auto&& [entityID, node, pins] : view.each())
 		{
-			auto view = character.mECS.view<DiceNode, InputOutputs>();
+			out << YAML::BeginMap;
+			out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
+			out << YAML::Key << "Outputs" << YAML::Value;
 			out << YAML::BeginSeq;
-			for (auto&& [entityID, node, pins] : view.each())
+			for (const auto& output : pins.Outputs)
 			{
-				out << YAML::BeginMap;
-				out << YAML::Key << "ID" << YAML::Value << (int64_t)node.ID.AsPointer();
-				out << YAML::Key << "Outputs" << YAML::Value;
-				out << YAML::BeginSeq;
-				for (const auto& output : pins.Outputs)
-				{
-					auto targets = FindTargets(character.mECS, output);
-					out << targets;
-				}
-				out << YAML::EndSeq;
-				out << YAML::EndMap;
+				const auto& targets = FindTargets(targetTable, output);
+				out << targets;
 			}
 			out << YAML::EndSeq;
+			out << YAML::EndMap;
 		}
-
-		out << YAML::EndMap;
+		out << YAML::EndSeq;
 	}
-	out << YAML::EndSeq;
-	out << YAML::EndMap;
 
-	std::ofstream ofs(filepath);
-	ofs << out.c_str();
+	out << YAML::EndMap;
 }
 
 
-[[nodiscard]] Node* ExportSerializer::FindNode(const entt::registry& reg, ed::PinId pinId)
+void ExportSerializer::BuildTargets(const Character& character, TargetTable& targetTable) const
 {
+	const auto& reg = character.mECS;
+	std::unordered_map<ed::PinId, uint64_t, IdHash<ed::PinId>> inputs;
+	auto addInput = [this, &reg, &inputs](entt::entity entityID, const Pin& input) {
+		if (Node* node = FindNodes(AnyNode{}, reg, entityID))
+			inputs.try_emplace(input.ID, (uint64_t)node->ID.AsPointer());
+	};
+
+	for (auto&& [entityID, pins] : reg.view<InputOutput>().each())
+		addInput(entityID, pins.Input);
+	for (auto&& [entityID, pins] : reg.view<ForkInputOutput>().each())
+		addInput(entityID, pins.Input);
+	for (auto&& [entityID, pins] : reg.view<InputOutputs>().each())
+		addInput(entityID, pins.Input);
+
+	// Visiting links in view order keeps every target list in the order it was always exported in
+	targetTable.clear();
+	for (auto&& [entityID, link] : reg.view<Link>().each())
 	{
-		auto view = reg.view<InputOutput>();
-		for (auto&& [entityID, node] : view.each())
-			if (node.Input.ID == pinId)
-				return FindNodes(AnyNode{}, reg, entityID);
-	}
-
-
-	{
-		auto view = reg.view<ForkInputOutput>();
-		for (auto&& [entityID, node] : view.each())
-			if (node.Input.ID == pinId)
-				return FindNodes(AnyNode{}, reg, entityID);
-	}
-
-
-	{
-		auto view = reg.view<InputOutputs>();
-		for (auto&& [entityID, node] : view.each())
-			if (node.Input.ID == pinId)
-				return FindNodes(AnyNode{}, reg, entityID);
+		uint64_t target = 0;
+		if (auto it = inputs.find(link.EndPinID); it != inputs.end())
+			target = it->second;
+		else if (auto it = mQuestInputs.find(link.EndPinID); it != mQuestInputs.end())
+			target = it->second;
+
+		if (target != 0)
+			targetTable[link.StartPinID].emplace_back(target);
 	}
+}
 
-	{
-		auto view = Character::sQuestECS.view<InputOutput>();
-		for (auto&& [entityID, node] : view.each())
-			if (node.Input.ID == pinId)
-				return FindNodes(AnyNode{}, Character::sQuestECS, entityID);
-	}
+void ExportSerializer::BuildQuestInputs(void)
+{
+	mQuestInputs.clear();
+	for (auto&& [entityID, pins] : Character::sQuestECS.view<InputOutput>().each())
+		if (Node* node = FindNodes(AnyNode{}, Character::sQuestECS, entityID))
+			mQuestInputs.try_emplace(pins.Input.ID, (uint64_t)node->ID.AsPointer());
+}
 
-	return nullptr;
+[[nodiscard]] const std::vector<uint64_t>& ExportSerializer::FindTargets(const TargetTable& targetTable, const Pin& pin)
+{
+	static const std::vector<uint64_t> NO_TARGETS = { 0 };
+	auto it = targetTable.find(pin.ID);
+	return it != targetTable.end() ? it->second : NO_TARGETS;
 }
 
-void ExportSerializer::SerializeLines(const std::string& filepath)
+bool ExportSerializer::SerializeLines(const std::string& filepath)
 {
-	std::ofstream ofs(filepath);
+	FileWriter file(filepath);
+	auto& ofs = file.GetStream();
 	for (const auto& characterData : mScene->mAllData)
 	{
 		auto view = characterData.Self.mECS.view<ActNode>();
 		for (auto&& [entityID, act] : view.each())
 			for (const auto& bubble : act.Bubbles)
 				ofs << bubble.second << '\n';
+		file.Flush();
 	}
-	ofs.close();
+	return file.Commit();
 }
 
 
@@ -0,0 +1,106 @@
+#include <FileWriter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <random>
+
+static constexpr size_t INITIAL_CAPACITY = 64 * 1024;
+
+/**
+* @brief Temporary file name next to the target that no other writer uses
+* @details The counter keeps writers of this process apart, the token drawn once per process
+*	keeps them apart from another process writing the same target.
+*/
+static std::string MakeTempFilepath(const std::string& filepath)
+{
+	static const uint32_t token = std::random_device{}();
+	static std::atomic<uint64_t> counter = 0;
+	return filepath + "." + std::to_string(token) + "." + std::to_string(counter++) + ".tmp";
+}
+
+FileWriter::FileWriter(const std::string& filepath, std::ios::openmode mode)
+	: mFilepath(filepath), mTempFilepath(MakeTempFilepath(filepath)), mFile(mTempFilepath, mode | std::ios::out | std::ios::trunc), mStream(&mBuffer)
+{
+	if (!mFile)
+		mStream.setstate(std::ios::badbit);
+}
+
+FileWriter::~FileWriter(void) noexcept
+{
+	if (mCommitted)
+		return;
+
+	mFile.close();
+	std::error_code error;
+	std::filesystem::remove(mTempFilepath, error);
+}
+
+void FileWriter::Flush(void)
+{
+	mFile.write(mBuffer.Data(), static_cast<std::streamsize>(mBuffer.Size()));
+	mBuffer.Reset();
+}
+
+bool FileWriter::Commit(void)
+{
+	Flush();
+	mFile.close();
+	if (!mFile || !mStream)
+		return false;
+
+	std::error_code error;
+	std::filesystem::rename(mTempFilepath, mFilepath, error);
+	mCommitted = !error;
+	return mCommitted;
+}
+
+FileWriter::Buffer::Buffer(void)
+	: mData(INITIAL_CAPACITY)
+{
+	Reset();
+}
+
+FileWriter::Buffer::int_type FileWriter::Buffer::overflow(int_type ch)
+{
+	if (traits_type::eq_int_type(ch, traits_type::eof()))
+		return traits_type::not_eof(ch);
+
+	Grow(1);
+	*pptr() = traits_type::to_char_type(ch);
+	pbump(1);
+	return ch;
+}
+
+std::streamsize FileWriter::Buffer::xsputn(const char* data, std::streamsize count)
+{
+	const size_t size = static_cast<size_t>(count);
+	if (static_cast<size_t>(epptr() - pptr()) < size)
+		Grow(size);
+
+	std::memcpy(pptr(), data, size);
+	Advance(size);
+	return count;
+}
+
+void FileWriter::Buffer::Grow(size_t required)
+{
+	// The buffer only grows, so after the largest chunk it never reallocates again
+	const size_t used = Size();
+	mData.resize(std::max(mData.size() * 2, used + required));
+	setp(mData.data(), mData.data() + mData.size());
+	Advance(used);
+}
+
+void FileWriter::Buffer::Advance(size_t count)
+{
+	// pbump only takes an int, a chunk past 2 GiB has to be skipped in several steps
+	while (count > 0)
+	{
+		const size_t step = std::min(count, static_cast<size_t>(std::numeric_limits<int>::max()));
+		pbump(static_cast<int>(step));
+		count -= step;
+	}
+}
@@ -0,0 +1,69 @@
+#include <History.h>
+
+void History::Push(std::unique_ptr<IAction> action)
+{
+	if (mGroupDepth > 0)
+	{
+		mGroup->Add(std::move(action));
+		return;
+	}
+
+	while (mEntries.size() > mCursor)
+	{
+		mSize -= mEntries.back()->GetSize();
+		mEntries.pop_back();
+	}
+
+	mSize += action->GetSize();
+	mEntries.emplace_back(std::move(action));
+	mCursor = mEntries.size();
+
+	// The newest entry is always kept, even if it's bigger than the whole budget on its own
+	while (mSize > mCapacity && mEntries.size() > 1)
+	{
+		mSize -= mEntries.front()->GetSize();
+		mEntries.pop_front();
+		mCursor--;
+	}
+}
+
+void History::BeginGroup(void)
+{
+	if (mGroupDepth++ == 0)
+		mGroup = std::make_unique<GroupAction>();
+}
+
+void History::EndGroup(void)
+{
+	if (mGroupDepth == 0 || --mGroupDepth > 0)
+		return;
+
+	auto group = std::move(mGroup);
+	if (!group->IsEmpty())
+		Push(std::move(group));
+}
+
+bool History::Undo(Character& character)
+{
+	if (!CanUndo() || mGroupDepth > 0)
+		return false;
+	mEntries[--mCursor]->MoveBack(character);
+	return true;
+}
+
+bool History::Redo(Character& character)
+{
+	if (!CanRedo() || mGroupDepth > 0)
+		return false;
+	mEntries[mCursor++]->MoveForward(character);
+	return true;
+}
+
+void History::Clear(void) noexcept
+{
+	mEntries.clear();
+	mCursor = 0;
+	mSize = 0;
+	mGroup.reset();
+	mGroupDepth = 0;
+}
@@ -0,0 +1,218 @@
+#include <Journal.h>
+#include <FileWriter.h>
+
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+static uint64_t Checksum(std::string_view data) noexcept;
+static std::string JoinIDs(const std::vector<size_t>& ids);
+static bool SplitIDs(std::string_view text, std::vector<size_t>& ids);
+
+Journal::~Journal(void) noexcept
+{
+	// Whatever is still pending is written before the editor goes away
+	Wait();
+	if (IsOpen() && !mPending.empty())
+		Write(mFilepath, mPending, mTruncate);
+}
+
+void Journal::Reset(const std::string& projectPath, const std::vector<size_t>& order)
+{
+	Wait();
+	std::error_code error;
+	const auto baseSize = std::filesystem::file_size(projectPath, error);
+
+	mFilepath = GetFilepath(projectPath);
+	mPending.clear();
+	mTruncate = true;
+	mFailed = false;
+	mSize = 0;
+	mBaseSize = error ? 0 : static_cast<size_t>(baseSize);
+	Append(RecordType::Base, 0, Stamp(projectPath) + ' ' + JoinIDs(order));
+}
+
+void Journal::AppendOrder(const std::vector<size_t>& order)
+{
+	if (IsOpen())
+		Append(RecordType::Order, 0, JoinIDs(order));
+}
+
+void Journal::AppendCharacter(size_t characterID, const std::string& yaml)
+{
+	if (IsOpen())
+		Append(RecordType::Character, characterID, yaml);
+}
+
+void Journal::Flush(void)
+{
+	if (!IsOpen() || mPending.empty())
+		return;
+
+	if (mWriting.valid())
+	{
+		if (mWriting.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+		Wait();
+	}
+
+	mWriting = std::async(std::launch::async, [filepath = mFilepath, records = std::move(mPending), truncate = mTruncate]() {
+		return Write(filepath, records, truncate);
+	});
+	mPending.clear();
+	mTruncate = false;
+}
+
+std::vector<Journal::Record> Journal::Read(const std::string& projectPath)
+{
+	const std::string filepath = GetFilepath(projectPath);
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file)
+		return {};
+
+	std::error_code error;
+	const auto fileSize = std::filesystem::file_size(filepath, error);
+	const std::string stamp = Stamp(projectPath);
+	if (error || stamp.empty())
+		return {};
+
+	std::vector<Record> records;
+	std::string header;
+	std::string payload;
+	while (std::getline(file, header))
+	{
+		char type = 0;
+		size_t characterID = 0;
+		size_t size = 0;
+		unsigned long long checksum = 0;
+		if (std::sscanf(header.c_str(), "%c %zu %zu %llx", &type, &characterID, &size, &checksum) != 4)
+			break;
+
+		// The size is checked against the file first, a damaged header could ask for anything
+		const auto offset = file.tellg();
+		if (offset < 0 || size >= fileSize - static_cast<size_t>(offset))
+			break;
+
+		payload.resize(size);
+		if (!file.read(payload.data(), static_cast<std::streamsize>(size)) || file.get() != '\n' || Checksum(payload) != checksum)
+			break;
+
+		Record record;
+		record.Type = static_cast<RecordType>(type);
+		record.CharacterID = characterID;
+		if (record.Type == RecordType::Base)
+		{
+			const size_t end = payload.find(' ');
+			if (!records.empty() || payload.compare(0, end, stamp) != 0)
+				return {};
+			if (end != std::string::npos && !SplitIDs(std::string_view(payload).substr(end + 1), record.Order))
+				return {};
+		}
+		else if (record.Type == RecordType::Order)
+		{
+			if (!SplitIDs(payload, record.Order))
+				break;
+		}
+		else if (record.Type == RecordType::Character)
+			record.Payload = payload;
+		else
+			break;
+
+		if (records.empty() && record.Type != RecordType::Base)
+			return {};
+		records.emplace_back(std::move(record));
+	}
+	return records;
+}
+
+void Journal::Append(RecordType type, size_t characterID, const std::string& payload)
+{
+	char header[80];
+	const int length = snprintf(header, sizeof(header), "%c %zu %zu %016llx\n", static_cast<char>(type), characterID, payload.size(), static_cast<unsigned long long>(Checksum(payload)));
+	mPending.append(header, static_cast<size_t>(length));
+	mPending += payload;
+	mPending += '\n';
+	mSize += static_cast<size_t>(length) + payload.size() + 1;
+}
+
+void Journal::Wait(void) noexcept
+{
+	if (!mWriting.valid())
+		return;
+
+	// A failed write may have left part of a record behind, nothing after it would be read back
+	try { mFailed |= !mWriting.get(); }
+	catch (...) { mFailed = true; }
+}
+
+bool Journal::Write(const std::string& filepath, const std::string& records, bool truncate)
+{
+	// A new journal replaces the old one atomically, after that records are only ever appended
+	if (truncate)
+	{
+		FileWriter file(filepath, std::ios::binary);
+		file.GetStream().write(records.data(), static_cast<std::streamsize>(records.size()));
+		return file.Commit();
+	}
+
+	std::ofstream file(filepath, std::ios::binary | std::ios::app);
+	file.write(records.data(), static_cast<std::streamsize>(records.size()));
+	file.flush();
+	return static_cast<bool>(file);
+}
+
+std::string Journal::Stamp(const std::string& projectPath)
+{
+	std::error_code error;
+	const auto size = std::filesystem::file_size(projectPath, error);
+	if (error)
+		return {};
+	const auto time = std::filesystem::last_write_time(projectPath, error);
+	if (error)
+		return {};
+	return std::to_string(size) + ':' + std::to_string(time.time_since_epoch().count());
+}
+
+uint64_t Checksum(std::string_view data) noexcept
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (const char c : data)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::string JoinIDs(const std::vector<size_t>& ids)
+{
+	std::string text;
+	for (const size_t id : ids)
+	{
+		if (!text.empty())
+			text += ' ';
+		text += std::to_string(id);
+	}
+	return text;
+}
+
+bool SplitIDs(std::string_view text, std::vector<size_t>& ids)
+{
+	const char* it = text.data();
+	const char* end = text.data() + text.size();
+	while (it != end)
+	{
+		size_t id = 0;
+		const auto [next, error] = std::from_chars(it, end, id);
+		if (error != std::errc{})
+			return false;
+		ids.push_back(id);
+		it = next;
+		if (it != end && *it++ != ' ')
+			return false;
+	}
+	return true;
+}
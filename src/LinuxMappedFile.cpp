@@ -0,0 +1,34 @@
+#ifndef PLATFORM_WINDOWS
+#include <MappedFile.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& filepath)
+{
+	const int fd = open(filepath.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			mData = data;
+			mSize = static_cast<size_t>(info.st_size);
+		}
+	}
+	close(fd);//The mapping keeps its own reference to the file
+}
+
+MappedFile::~MappedFile(void) noexcept
+{
+	if (mData)
+		munmap(const_cast<void*>(mData), mSize);
+}
+
+#endif
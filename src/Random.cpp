@@ -1,21 +1,8 @@
 #include "Random.h"
 #include <random>
-#include <array>
-#include <algorithm>
 
-static std::mt19937 sEngine;
-static std::uniform_int_distribution<std::mt19937::result_type> sUniformDistrubution;
-
-void Random::Init()
+uint64_t Random::RandomSeed(void)
 {
 	std::random_device rd;
-	std::array<int, std::mt19937::state_size> seed_data;
-	std::generate_n(seed_data.data(), seed_data.size(), std::ref(rd));
-	std::seed_seq seq(std::begin(seed_data), std::end(seed_data));
-	sEngine = std::mt19937(seq);
+	return (uint64_t{ rd() } << 32) | rd();
 }
-
-float Random::Float(void)
-{
-	return (float)sUniformDistrubution(sEngine) / (float)std::numeric_limits<uint32_t>::max();
-}
\ No newline at end of file
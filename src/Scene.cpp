@@ -1,22 +1,56 @@
 #include "Scene.h"
 #include "SceneSerializer.h"
 #include "ExportSerializer.h"
+#include "BinaryExportSerializer.h"
 #include <FileDialog.h>
+#include <MappedFile.h>
 
+#include <yaml-cpp/yaml.h>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
 
 #include <imgui_internal.h>
 
-std::array<bool, 7> Scene::sWindows = { true, true, true, true, true, true, true };
+std::array<bool, 8> Scene::sWindows = { true, true, true, true, true, true, true, false };
+
+/**
+* @brief A file being loaded in the background, the frame keeps rendering until it's ready
+*/
+struct Scene::PendingOpen {
+    std::string Filepath;
+    SceneSerializer::LoadProgress Progress;
+    std::future<std::unique_ptr<SceneSerializer::LoadedScene>> Result;
+};
+
+/**
+* @brief A Character compiled for the Simulator, the workers read the program and state while Result is pending
+*/
+struct Scene::Simulation {
+    size_t CharacterID = 0;
+    std::string Name;
+    DialogueProgram Program;
+    StateMachine Initial;
+    Simulator::Settings Settings;
+    Simulator::Progress Progress;
+    Simulator::Report Report;
+    std::future<Simulator::Report> Result;//Last member, so it's waited for before the rest goes away
+};
 
 using namespace ax;
 
+static constexpr std::chrono::seconds AUTOSAVE_INTERVAL{ 3 };
+
 void ShowStyleEditor(bool* show = nullptr);
 void TextWithBackgroundColor(const char* text, const ImVec4& bgColor);
 static bool Searchbar(const char* label, std::string& text, size_t length, float width = 200.0f);
 
 void Scene::RenderFrame(void) noexcept
 {
+    UpdateOpen();
+    Autosave();
     mAllData[mWorkingDataIndex].Self.UpdateTouch();
 
     if (ImGui::BeginMainMenuBar())
@@ -36,6 +70,38 @@ void Scene::RenderFrame(void) noexcept
                     ExportSerializer{ this }.Serialize(filepath.string());
                 }
             }
+            if (ImGui::MenuItem("Export Binary..."))
+            {
+                std::filesystem::path filepath = CreateFileDialog(FileDialogType::Save, "Binary Puru Puru File (*.bpuru)\0*.bpuru\0");
+                if (!filepath.empty())
+                {
+                    filepath.replace_extension(".bpuru");
+                    BinaryExportSerializer{ this }.Serialize(filepath.string());
+#ifdef PURU_DEBUG
+                    MappedFile file(filepath.string());
+                    IM_ASSERT(BinaryExport(file.Data(), file.Size()).Validate() == nullptr && "Binary export is malformed");
+#endif
+                }
+            }
+            if (ImGui::MenuItem("Dump Binary Export..."))
+            {
+                // Writes a binary export back as YAML, to cross-check it against the .epuru of the same project
+                std::filesystem::path filepath = CreateFileDialog(FileDialogType::Open, "Binary Puru Puru File (*.bpuru)\0*.bpuru\0");
+                if (!filepath.empty())
+                {
+                    MappedFile file(filepath.string());
+                    BinaryExport binaryExport(file.Data(), file.Size());
+                    if (const char* error = binaryExport.Validate())
+                        std::cout << filepath.string() << ": " << error << '\n';
+                    else
+                    {
+                        YAML::Emitter out;
+                        binaryExport.DumpYAML(out);
+                        std::ofstream ofs(filepath.replace_extension(".dump.epuru"));
+                        ofs << out.c_str();
+                    }
+                }
+            }
             if (ImGui::MenuItem("Export Lines..."))
             {
                 std::filesystem::path filepath = CreateFileDialog(FileDialogType::Save);
@@ -44,6 +110,13 @@ void Scene::RenderFrame(void) noexcept
             }
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("Edit"))
+        {
+            const auto& character = mAllData[mWorkingDataIndex].Self;
+            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, !mDebuging && character.CanUndo())) Undo();
+            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, !mDebuging && character.CanRedo())) Redo();
+            ImGui::EndMenu();
+        }
         if (ImGui::BeginMenu("View"))
         {
             ImGui::MenuItem("Characters", nullptr, &sWindows[CHARACTERS_INDEX]);
@@ -53,6 +126,7 @@ void Scene::RenderFrame(void) noexcept
             ImGui::MenuItem("Dialogues", nullptr, &sWindows[DIALOGUE_INDEX]);
             ImGui::MenuItem("Variables", nullptr, &sWindows[VARIABLE_INDEX]);
             ImGui::MenuItem("Quests", nullptr, &sWindows[QUEST_INDEX]);
+            ImGui::MenuItem("Simulation", nullptr, &sWindows[SIMULATION_INDEX]);
             ImGui::EndMenu();
         }
         ImGui::EndMainMenuBar();
@@ -62,14 +136,33 @@ void Scene::RenderFrame(void) noexcept
     const bool ctrl = io.KeyCtrl;
     const bool shift = io.KeyShift;
 
-    if (ctrl && shift && ImGui::IsKeyDown(ImGuiKey_S))
-        SaveAs();
-    if (ctrl && ImGui::IsKeyDown(ImGuiKey_S))
-        Save();
-    if (ctrl && ImGui::IsKeyDown(ImGuiKey_O))
+    // Only on the frame the key goes down, holding it doesn't save again every frame
+    if (ctrl && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_S), false))
+    {
+        if (shift)
+            SaveAs();
+        else
+            Save();
+    }
+    if (ctrl && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_O), false))
         Open();
 
+    // Text fields undo their own typing while they're active
+    if (ctrl && !io.WantTextInput && !mDebuging)
+    {
+        if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Z)))
+        {
+            if (shift)
+                Redo();
+            else
+                Undo();
+        }
+        if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Y)))
+            Redo();
+    }
+
     ShowPanels();
+    ShowSimulation();
 
     ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0, 0 });
     ImGui::Begin("Node Editor", nullptr);
@@ -147,6 +240,14 @@ void Scene::ShowPanels()
                 }
             }
 
+            // Speaking again with the seed a session showed replays its dice
+            if (mDebuging)
+            {
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(160.0f);
+                ImGui::InputScalar("Seed", ImGuiDataType_U64, &mSeed);
+            }
+
             size_t delIndex = INVALID_ID;
             for (size_t i = 0; i < mAllData.size(); i++)
             {
@@ -162,7 +263,10 @@ void Scene::ShowPanels()
                 ImGui::PopStyleColor();
 
                 if (i == mEditingIndex)
-                    ImGui::InputText("##CharacterName", data.Name, 64);
+                {
+                    if (ImGui::InputText("##CharacterName", data.Name, 64))
+                        data.Self.MarkDirty();
+                }
                 else
                     TextWithBackgroundColor(data.Name, i == mWorkingDataIndex ? ImVec4{0.33f, 0.33f, 0.33f, 1.0f} : ImVec4{ 0.0f, 0.0f, 0.0f, 0.0f });
 
@@ -181,7 +285,10 @@ void Scene::ShowPanels()
                     if (ImGui::Button("Speak"))
                     {
                         mWorkingDataIndex = i;
-                        mDebugingID = mAllData[mWorkingDataIndex].Self.GetEntryNodeID();
+                        mProgram = DialogueProgram{ mAllData[mWorkingDataIndex].Self, mStateMachine };
+                        mProgramCounter = mProgram.GetEntry();
+                        mSessionSeed = mSeed != 0 ? mSeed : Random::RandomSeed();
+                        mRandom.Seed(mSessionSeed);
                         mDone = true;
                         mSpeaking = true;
                     }
@@ -217,13 +324,16 @@ void Scene::ShowPanels()
                 Searchbar("bool string", boolFilter, 64);
                 ImGui::Separator();
                 //Draw searchbar control
-                for (auto&& [var, val] : mStateMachine.Booleans())
+                for (StateMachine::Slot slot = 0; slot < mStateMachine.Size(); slot++)
                 {
-                    if (var.find(boolFilter) == std::string::npos)
+                    const auto& var = mStateMachine.GetName(slot);
+                    if (!mStateMachine.Exists(slot) || var.find(boolFilter) == std::string::npos)
                         continue;
                     ImGui::Text(var.c_str()); ImGui::SameLine();
                     const auto lbl = std::string("##") + var;
-                    ImGui::Checkbox(lbl.c_str(), &val);
+                    bool val = mStateMachine.GetBoolValue(slot);
+                    if (ImGui::Checkbox(lbl.c_str(), &val))
+                        mStateMachine.SetValue(slot, val);
                 }
                 ImGui::TreePop();
             }
@@ -234,13 +344,16 @@ void Scene::ShowPanels()
                 static std::string intFilter;
                 Searchbar("int string", intFilter, 64);
                 ImGui::Separator();
-                for (auto&& [var, val] : mStateMachine.Integers())
+                for (StateMachine::Slot slot = 0; slot < mStateMachine.Size(); slot++)
                 {
-                    if (var.find(intFilter) == std::string::npos)
+                    const auto& var = mStateMachine.GetName(slot);
+                    if (!mStateMachine.IsInteger(slot) || var.find(intFilter) == std::string::npos)
                         continue;
                     ImGui::Text(var.c_str()); ImGui::SameLine();
                     const auto lbl = std::string("##") + var;
-                    ImGui::DragInt(lbl.c_str(), &val);
+                    int32_t val = mStateMachine.GetIntValue(slot);
+                    if (ImGui::DragInt(lbl.c_str(), &val))
+                        mStateMachine.SetValue(slot, val);
                 }
                 ImGui::TreePop();
             }
@@ -248,11 +361,14 @@ void Scene::ShowPanels()
             const bool forks = ImGui::TreeNodeEx("Forks", treeNodeFlags);
             if (forks)
             {
-                for (auto&& [var, val] : mStateMachine.Forks())
+                for (StateMachine::Slot fork = 0; fork < mStateMachine.ForkCount(); fork++)
                 {
-                    ImGui::Text(var.str().c_str()); ImGui::SameLine();
-                    const auto lbl = std::string("##") + var.str();
-                    ImGui::Checkbox(lbl.c_str(), &val);
+                    const auto var = mStateMachine.GetFork(fork).str();
+                    ImGui::Text(var.c_str()); ImGui::SameLine();
+                    const auto lbl = std::string("##") + var;
+                    bool val = mStateMachine.IsVisited(fork);
+                    if (ImGui::Checkbox(lbl.c_str(), &val))
+                        mStateMachine.SetVisited(fork, val);
                 }
                 ImGui::TreePop();
             }
@@ -285,32 +401,33 @@ void Scene::ShowPanels()
     {   
         if (ImGui::Begin("Dialogues", &sWindows[DIALOGUE_INDEX]))
         {
-            auto& character = mAllData[mWorkingDataIndex].Self;
             auto npcFlavor = mAllData[mWorkingDataIndex].CharacterFlavor;
-            auto curr = character.FindEntity(Node{mDebugingID}.ID);
-            auto pair = std::make_pair(character.FindNodes(AnyNode{}, curr), character.FindNodeType(curr));
+            auto op = mProgram.GetOpCode(mProgramCounter);
+            ImGui::TextDisabled("Seed %llu", static_cast<unsigned long long>(mSessionSeed));
             if (mDone)
             {
+                auto pc = mProgramCounter;
                 do
                 {
-                    pair = mAllData[mWorkingDataIndex].Self.FindNextNode((int32_t)(u64)pair.first->ID.AsPointer(), mStateMachine, std::make_pair(mainCharacterFlavor, npcFlavor), mChoice);
+                    pc = mProgram.Step(pc, mStateMachine, std::make_pair(mainCharacterFlavor, npcFlavor), mRandom, mChoice);
+                    op = mProgram.GetOpCode(pc);
                 }
-                while (pair.second != NodeType::Act && pair.second != NodeType::Dialogue && pair.second != NodeType::None);
-                mDone = pair.second == NodeType::None;
+                while (op != NodeType::Act && op != NodeType::Dialogue && op != NodeType::None);
+                mDone = op == NodeType::None;
                 if (!mDone)
-                    mDebugingID = (int32_t)(u64)pair.first->ID.AsPointer();
-                if (pair.second == NodeType::Act)
+                    mProgramCounter = pc;
+                if (op == NodeType::Act)
                     mChoice = 0;
                 else
                     mChoice = -1;
             }
 
-            if (pair.second == NodeType::Dialogue)
+            if (op == NodeType::Dialogue)
             {
-                auto* dialogueNode = (DialogueNode*)pair.first;
-                for (int32_t i = 0; i < dialogueNode->Prompts.size(); i++)
+                const auto prompts = mProgram.GetPrompts(mProgramCounter);
+                for (int32_t i = 0; i < prompts.size(); i++)
                 {
-                    const auto& prompt = dialogueNode->Prompts[i];
+                    const auto& prompt = prompts[i];
                     if (ImGui::Button(prompt.c_str()))
                     {
                         mChoice = i;
@@ -318,10 +435,10 @@ void Scene::ShowPanels()
                     }
                 }
             }
-            else if (pair.second == NodeType::Act)
+            else if (op == NodeType::Act)
             {
-                auto* actNode = (ActNode*)pair.first;
-                auto&& [speaker, line] = actNode->Bubbles[mChoice];
+                const auto bubbles = mProgram.GetBubbles(mProgramCounter);
+                auto&& [speaker, line] = bubbles[mChoice];
                 ImGui::Text(speaker == Speaker::NPC ? "NPC:" : "Main Character:");
                 ImGui::TextWrapped(line.c_str());
 
@@ -329,7 +446,7 @@ void Scene::ShowPanels()
                 const bool button = ImGui::Button("Next");
                 if (space || button)
                 {
-                    if (++mChoice >= actNode->Bubbles.size())
+                    if (++mChoice >= bubbles.size())
                         mDone = true;
                 }
             }
@@ -490,11 +607,16 @@ void Scene::ShowPanels()
 
 
 
-Scene::Scene(void)
+Scene::Scene(bool headless)
+    : mHeadless(headless)
 {
-    ed::Config config;
-    auto* editor = ed::CreateEditor(&config);
-    ed::SetCurrentEditor(editor);
+    ed::EditorContext* editor = nullptr;
+    if (!headless)
+    {
+        ed::Config config;
+        editor = ed::CreateEditor(&config);
+        ed::SetCurrentEditor(editor);
+    }
     mAllData.emplace_back(CharacterData{ editor });
     mWorkingDataIndex = 0;
 }
@@ -576,8 +698,11 @@ void ShowStyleEditor(bool* show)
 
 Scene::~Scene(void)
 {
+    if (mSimulation)
+        mSimulation->Progress.Cancelled = true;
     for (const auto& data : mAllData)
-        ed::DestroyEditor(data.Editor);
+        if (data.Editor)
+            ed::DestroyEditor(data.Editor);
 }
 
 
@@ -600,10 +725,27 @@ void TextWithBackgroundColor(const char* text, const ImVec4& bgColor)
     ImGui::Text("%s", text);
 }
 
+void Scene::Undo(void)
+{
+    auto& data = mAllData[mWorkingDataIndex];
+    ed::SetCurrentEditor(data.Editor);
+    data.Self.Undo();
+}
+
+void Scene::Redo(void)
+{
+    auto& data = mAllData[mWorkingDataIndex];
+    ed::SetCurrentEditor(data.Editor);
+    data.Self.Redo();
+}
+
 void Scene::Save()
 {
     if (!mLastFilepath.empty())
-        SceneSerializer{ this }.Serialize(mLastFilepath);
+    {
+        if (SceneSerializer{ this }.Serialize(mLastFilepath))
+            ResetJournal();
+    }
     else
         SaveAs();
 }
@@ -620,12 +762,271 @@ void Scene::SaveAs()
 
 void Scene::Open()
 {
+    if (mPendingOpen)//Only one file is opened at a time
+        return;
+
     std::filesystem::path path = CreateFileDialog(FileDialogType::Open);
     if (!path.empty())
     {
-        mLastFilepath = (path.replace_extension(".puru")).string();
-        SceneSerializer{ this }.Deserialize(path.string());
+        mPendingOpen = std::make_unique<PendingOpen>();
+        mPendingOpen->Filepath = path.string();
+        mPendingOpen->Result = std::async(std::launch::async, [filepath = mPendingOpen->Filepath, progress = &mPendingOpen->Progress]() {
+            // Changes autosaved after the last full save are recovered on top of the file
+            auto loaded = SceneSerializer::Load(filepath, progress);
+            if (loaded)
+                SceneSerializer::Replay(filepath, *loaded);
+            return loaded;
+        });
+    }
+}
+
+void Scene::UpdateOpen(void)
+{
+    if (!mPendingOpen)
+        return;
+
+    if (mPendingOpen->Result.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        // The Scene is only replaced on the main thread, once every Character is built
+        try
+        {
+            if (auto loaded = mPendingOpen->Result.get())
+            {
+                SceneSerializer{ this }.Apply(*loaded);
+                mLastFilepath = std::filesystem::path(mPendingOpen->Filepath).replace_extension(".puru").string();
+                ResetJournal(loaded->Replayed);
+            }
+        }
+        catch (const std::exception& e) { std::cout << mPendingOpen->Filepath << ": " << e.what() << '\n'; }
+        mPendingOpen.reset();
+        return;
+    }
+
+    const ImVec2 center = ImGui::GetIO().DisplaySize * 0.5f;
+    ImGui::SetNextWindowPos(center, ImGuiCond_Always, { 0.5f, 0.5f });
+    ImGui::OpenPopup("Opening");
+    if (ImGui::BeginPopupModal("Opening", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove))
+    {
+        const size_t size = mPendingOpen->Progress.FileSize;
+        const size_t read = mPendingOpen->Progress.BytesRead;
+        const size_t built = mPendingOpen->Progress.Built;
+        ImGui::TextUnformatted(mPendingOpen->Filepath.c_str());
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%zu characters", built);
+        ImGui::ProgressBar(size == 0 ? 0.0f : static_cast<float>(read) / static_cast<float>(size), { 300.0f, 0.0f }, overlay);
+        ImGui::EndPopup();
+    }
+}
+
+void Scene::StartSimulation(size_t index, const Simulator::Settings& settings)
+{
+    if (mSimulation && mSimulation->Result.valid())//Only one simulation runs at a time
+        return;
+
+    // Compiled here since quests live in this thread's registry, variables start out like in the debugger
+    const auto& data = mAllData[index];
+    mSimulation = std::make_unique<Simulation>();
+    mSimulation->CharacterID = data.Self.GetID();
+    mSimulation->Name = data.Name;
+    mSimulation->Settings = settings;
+    data.Self.SetupVariables(mSimulation->Initial);
+    mSimulation->Program = DialogueProgram{ data.Self, mSimulation->Initial };
+    mSimulation->Result = std::async(std::launch::async, [simulation = mSimulation.get()]() {
+        return Simulator::Run(simulation->Program, simulation->Initial, simulation->Settings, &simulation->Progress);
+    });
+}
+
+void Scene::ShowSimulation(void)
+{
+    static Simulator::Settings settings;
+    static bool neverReachedOnly = false;
+
+    // Polled even while the window is closed, so the workers are joined as soon as they're done
+    const bool running = mSimulation && mSimulation->Result.valid();
+    if (running && mSimulation->Result.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        mSimulation->Report = mSimulation->Result.get();
+
+    if (!sWindows[SIMULATION_INDEX])
+        return;
+
+    if (ImGui::Begin("Simulation", &sWindows[SIMULATION_INDEX]))
+    {
+        ImGui::InputScalar("Runs", ImGuiDataType_U64, &settings.Runs);
+        ImGui::InputScalar("Max Steps", ImGuiDataType_U32, &settings.MaxSteps);
+        ImGui::InputScalar("Seed", ImGuiDataType_U64, &settings.Seed);
+        settings.Runs = std::max<uint64_t>(settings.Runs, 1);
+        settings.MaxSteps = std::max<uint32_t>(settings.MaxSteps, 1);
+
+        if (mSimulation && mSimulation->Result.valid())
+        {
+            const uint64_t done = mSimulation->Progress.Done;
+            char overlay[64];
+            snprintf(overlay, sizeof(overlay), "%llu / %llu", static_cast<unsigned long long>(done), static_cast<unsigned long long>(mSimulation->Settings.Runs));
+            ImGui::ProgressBar(static_cast<float>(done) / static_cast<float>(mSimulation->Settings.Runs), { -1.0f, 0.0f }, overlay);
+            if (ImGui::Button("Cancel"))
+                mSimulation->Progress.Cancelled = true;
+        }
+        else
+        {
+            const std::string label = std::string("Simulate ") + mAllData[mWorkingDataIndex].Name;
+            if (ImGui::Button(label.c_str()))
+                StartSimulation(mWorkingDataIndex, settings);
+        }
+
+        if (mSimulation && !mSimulation->Result.valid())
+        {
+            const auto& program = mSimulation->Program;
+            const auto& report = mSimulation->Report;
+            ImGui::Separator();
+            if (program.GetEntry() == DialogueProgram::END)
+                ImGui::Text("%s has no entry node", mSimulation->Name.c_str());
+            else
+            {
+                const size_t reached = program.Size() - static_cast<size_t>(std::count(report.Visits.begin(), report.Visits.end(), 0));
+                ImGui::Text("%s: %llu runs, %zu/%zu nodes reached", mSimulation->Name.c_str(), static_cast<unsigned long long>(report.Runs), reached, program.Size());
+                ImGui::Text("Length %u to %u, %.1f on average", report.MinLength, report.MaxLength, report.GetMeanLength());
+                if (report.Cut > 0)
+                    ImGui::Text("%llu cut at %u steps", static_cast<unsigned long long>(report.Cut), mSimulation->Settings.MaxSteps);
+
+                std::array<float, std::tuple_size_v<decltype(report.Lengths)>> lengths;
+                int bucketCount = 0;
+                for (size_t bucket = 0; bucket < lengths.size(); bucket++)
+                {
+                    lengths[bucket] = static_cast<float>(report.Lengths[bucket]);
+                    bucketCount = report.Lengths[bucket] > 0 ? static_cast<int>(bucket) + 1 : bucketCount;
+                }
+                ImGui::PlotHistogram("Lengths", lengths.data(), bucketCount, 0, "By powers of two", 0.0f, FLT_MAX, { 0.0f, 60.0f });
+                ImGui::Checkbox("Never reached only", &neverReachedOnly);
+            }
+
+            std::vector<uint32_t> rows;
+            rows.reserve(program.Size());
+            for (uint32_t pc = 0; pc < program.Size(); pc++)
+                if (!neverReachedOnly || report.Visits[pc] == 0)
+                    rows.push_back(pc);
+
+            // Rows are only clickable while the simulated Character is the one in the node editor
+            const bool navigable = mAllData[mWorkingDataIndex].Self.GetID() == mSimulation->CharacterID;
+            ImGui::Columns(5, "Simulated Nodes");
+            ImGui::Text("Node"); ImGui::NextColumn();
+            ImGui::Text("Type"); ImGui::NextColumn();
+            ImGui::Text("Visits"); ImGui::NextColumn();
+            ImGui::Text("Ended"); ImGui::NextColumn();
+            ImGui::Text("Outputs"); ImGui::NextColumn();
+            ImGui::Separator();
+
+            ImGuiListClipper clipper(static_cast<int>(rows.size()));
+            while (clipper.Step())
+            {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+                {
+                    const uint32_t pc = rows[row];
+                    const auto& instruction = program.GetInstruction(pc);
+                    const bool neverReached = report.Visits[pc] == 0;
+                    if (neverReached)
+                        ImGui::PushStyleColor(ImGuiCol_Text, { 0.9f, 0.3f, 0.3f, 1.0f });
+
+                    char label[32];
+                    snprintf(label, sizeof(label), "%d##%u", instruction.NodeID, pc);
+                    if (ImGui::Selectable(label, false, ImGuiSelectableFlags_SpanAllColumns) && navigable)
+                    {
+                        ed::SelectNode(static_cast<uintptr_t>(instruction.NodeID));
+                        ed::NavigateToSelection();
+                    }
+                    ImGui::NextColumn();
+                    ImGui::TextUnformatted(DialogueProgram::GetOpName(instruction.Op)); ImGui::NextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(report.Visits[pc])); ImGui::NextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(report.Ends[pc])); ImGui::NextColumn();
+
+                    std::string outputs;
+                    for (uint32_t output = 0; output < instruction.SuccessorCount; output++)
+                        outputs += (output == 0 ? "" : " ") + std::to_string(report.GetTaken(program, pc, output));
+                    ImGui::TextUnformatted(outputs.c_str()); ImGui::NextColumn();
+
+                    if (neverReached)
+                        ImGui::PopStyleColor();
+                }
+            }
+            ImGui::Columns(1);
+        }
+    }
+    ImGui::End();
+}
+
+void Scene::Autosave(void)
+{
+    if (!mJournal.IsOpen() || mPendingOpen)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - mLastAutosave < AUTOSAVE_INTERVAL)
+        return;
+    mLastAutosave = now;
+
+    // Only Characters edited since the last autosave are serialized, and only written if they changed
+    SceneSerializer serializer{ this };
+    for (size_t i = 0; i < mAllData.size(); i++)
+    {
+        const auto& character = mAllData[i].Self;
+        auto& journaled = mJournaled[character.GetID()];
+        if (journaled.Revision == character.GetRevision())
+            continue;
+
+        journaled.Revision = character.GetRevision();
+        const std::string yaml = serializer.SerializeCharacter(i);
+        const size_t hash = std::hash<std::string>{}(yaml);
+        if (hash != journaled.Hash)
+        {
+            journaled.Hash = hash;
+            mJournal.AppendCharacter(character.GetID(), yaml);
+        }
+    }
+    ed::SetCurrentEditor(mAllData[mWorkingDataIndex].Editor);
+
+    // After the Characters, so a new Character is in the journal before it's listed
+    auto order = GetCharacterOrder();
+    if (order != mJournaledOrder)
+    {
+        mJournal.AppendOrder(order);
+        mJournaledOrder = std::move(order);
     }
+
+    if (mJournal.NeedsRewrite())
+        Save();
+    else
+        mJournal.Flush();
+}
+
+void Scene::ResetJournal(const std::vector<Journal::Record>& replayed)
+{
+    mJournaledOrder = GetCharacterOrder();
+    mJournaled.clear();
+    for (const auto& data : mAllData)
+        mJournaled[data.Self.GetID()] = { data.Self.GetRevision(), 0 };
+
+    mJournal.Reset(mLastFilepath, replayed.empty() ? mJournaledOrder : replayed.front().Order);
+    for (size_t i = 1; i < replayed.size(); i++)
+    {
+        const auto& record = replayed[i];
+        if (record.Type == Journal::RecordType::Character)
+        {
+            mJournal.AppendCharacter(record.CharacterID, record.Payload);
+            mJournaled[record.CharacterID].Hash = std::hash<std::string>{}(record.Payload);
+        }
+        else
+            mJournal.AppendOrder(record.Order);
+    }
+    mJournal.Flush();
+    mLastAutosave = std::chrono::steady_clock::now();
+}
+
+std::vector<size_t> Scene::GetCharacterOrder(void) const
+{
+    std::vector<size_t> order;
+    order.reserve(mAllData.size());
+    for (const auto& data : mAllData)
+        order.push_back(data.Self.GetID());
+    return order;
 }
 
 static bool Searchbar(const char* label, std::string& text, size_t length, float width)
@@ -0,0 +1,833 @@
+#include <SceneReader.h>
+
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <istream>
+
+static SetOperator DeserializeSetOperator(const std::string& pOperator);
+static CompareOperator DeserializeCompareOperator(const std::string& pOperator);
+static Speaker DeserializeSpeaker(const std::string& pSpeaker);
+
+/**
+* @brief Converts a scalar the way YAML::Node::as<T> does
+* @details Plain decimals take a fast path, anything else (octal, hex, special floats...) is left to yaml-cpp
+*/
+template<typename T>
+[[nodiscard]] static T Convert(const std::string& value, const YAML::Mark& mark);
+
+// A null converts to this string and to nothing else, same as a YAML::Node
+static const std::string NULL_SCALAR = "null";
+
+template<typename T>
+[[nodiscard]] static T Decode(const std::string& value, const YAML::Mark& mark)
+{
+	T result;
+	if (!YAML::convert<T>::decode(YAML::Node(value), result))
+		throw YAML::TypedBadConversion<T>(mark);
+	return result;
+}
+
+template<>
+int32_t Convert<int32_t>(const std::string& value, const YAML::Mark& mark)
+{
+	// A leading zero makes yaml-cpp read the number as octal
+	const char* first = value.data();
+	const char* last = first + value.size();
+	const char* digits = first != last && *first == '-' ? first + 1 : first;
+	if (digits != last && (*digits != '0' || last - digits == 1))
+	{
+		int32_t result = 0;
+		const auto [end, error] = std::from_chars(first, last, result);
+		if (error == std::errc() && end == last)
+			return result;
+	}
+	return Decode<int32_t>(value, mark);
+}
+
+template<>
+float Convert<float>(const std::string& value, const YAML::Mark& mark)
+{
+	// Infinities, NaNs and subnormals keep going through yaml-cpp, which handles them its own way
+	const char* first = value.data();
+	const char* last = first + value.size();
+	const char* digits = first != last && *first == '-' ? first + 1 : first;
+	if (digits != last && (std::isdigit(static_cast<unsigned char>(*digits)) || *digits == '.'))
+	{
+		float result = 0.0f;
+		const auto [end, error] = std::from_chars(first, last, result);
+		if (error == std::errc() && end == last && (result == 0.0f || std::isnormal(result)))
+			return result;
+	}
+	return Decode<float>(value, mark);
+}
+
+template<>
+bool Convert<bool>(const std::string& value, const YAML::Mark& mark)
+{
+	if (value == "true")
+		return true;
+	if (value == "false")
+		return false;
+	return Decode<bool>(value, mark);
+}
+
+template<typename T>
+T SceneReader::Fields::As(Field field) const
+{
+	return Convert<T>(Get(field), Mark);
+}
+
+void SceneReader::Fields::Reset(const YAML::Mark& mark) noexcept
+{
+	Present = 0;
+	Mark = mark;
+}
+
+const std::string& SceneReader::Fields::Get(Field field) const
+{
+	if (!Has(field))
+		throw YAML::KeyNotFound(Mark, std::string(GetFieldKey(field)));
+	return Values[field];
+}
+
+std::string& SceneReader::List::Add(void)
+{
+	if (Count == Items.size())
+		Items.emplace_back();
+	return Items[Count++];
+}
+
+const std::string& SceneReader::List::Get(size_t index, const YAML::Mark& mark) const
+{
+	if (index >= Count)
+		throw YAML::RepresentationException(mark, "not enough elements in the list");
+	return Items[index];
+}
+
+SceneReader::SceneReader(CharacterCallback onCharacter)
+	: mOnCharacter(std::move(onCharacter)) {}
+
+void SceneReader::Read(std::istream& is)
+{
+	YAML::Parser parser(is);
+	parser.HandleNextDocument(*this);
+}
+
+void SceneReader::OnNull(const YAML::Mark& mark, YAML::anchor_t)
+{
+	mOffset = mark.pos;
+	if (mSkipping > 0)
+		return;
+
+	if (!mFrames.empty() && mFrames.back().IsMap && mFrames.back().AwaitingKey)
+	{
+		mFrames.back().Key = KEY_NONE;
+		mFrames.back().AwaitingKey = false;
+		return;
+	}
+	ReadScalar(mark, NULL_SCALAR);
+	EndValue();
+}
+
+void SceneReader::OnAlias(const YAML::Mark& mark, YAML::anchor_t)
+{
+	mOffset = mark.pos;
+	if (mSkipping > 0)
+		return;
+	throw YAML::ParserException(mark, "aliases aren't supported in .puru files");
+}
+
+void SceneReader::OnScalar(const YAML::Mark& mark, const std::string&, YAML::anchor_t, const std::string& value)
+{
+	mOffset = mark.pos;
+	if (mSkipping > 0)
+		return;
+
+	if (!mFrames.empty() && mFrames.back().IsMap && mFrames.back().AwaitingKey)
+	{
+		mFrames.back().Key = FindKey(GetLevel(), value);
+		mFrames.back().AwaitingKey = false;
+		return;
+	}
+	ReadScalar(mark, value);
+	EndValue();
+}
+
+void SceneReader::OnSequenceStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value)
+{
+	mOffset = mark.pos;
+	if (mSkipping > 0)
+	{
+		mSkipping++;
+		return;
+	}
+
+	if (!mFrames.empty() && mFrames.back().IsMap && mFrames.back().AwaitingKey)
+		throw YAML::ParserException(mark, "keys of .puru files are scalars");
+	if (!BeginCollection(mark, false))
+	{
+		mSkipping = 1;
+		return;
+	}
+	mFrames.push_back({ false });
+}
+
+void SceneReader::OnSequenceEnd(void)
+{
+	if (mSkipping > 0)
+	{
+		if (--mSkipping == 0)
+			EndValue();
+		return;
+	}
+
+	mFrames.pop_back();
+	EndCollection(false);
+	EndValue();
+}
+
+void SceneReader::OnMapStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value)
+{
+	mOffset = mark.pos;
+	if (mSkipping > 0)
+	{
+		mSkipping++;
+		return;
+	}
+
+	if (!mFrames.empty() && mFrames.back().IsMap && mFrames.back().AwaitingKey)
+		throw YAML::ParserException(mark, "keys of .puru files are scalars");
+	if (!BeginCollection(mark, true))
+	{
+		mSkipping = 1;
+		return;
+	}
+	mFrames.push_back({ true });
+}
+
+void SceneReader::OnMapEnd(void)
+{
+	if (mSkipping > 0)
+	{
+		if (--mSkipping == 0)
+			EndValue();
+		return;
+	}
+
+	mFrames.pop_back();
+	EndCollection(true);
+	EndValue();
+}
+
+uint8_t SceneReader::FindKey(Level level, std::string_view key) noexcept
+{
+	static constexpr std::array<std::string_view, SECTION_COUNT + 1> SECTION_KEYS = {
+		"EntryNode", "VariableNodes", "ActNodes", "ForkNodes", "BranchNodes", "DialogueNodes", "FlavorMatchNodes",
+		"FlavorCheckNodes", "DiceNodes", "AcceptQuestNodes", "ReturnQuestNodes", "ObjectiveNodes", "Comments", "Links",
+		"Name"
+	};
+
+	if (level == LEVEL_CHARACTER)
+	{
+		const auto it = std::find(SECTION_KEYS.begin(), SECTION_KEYS.end(), key);
+		return it == SECTION_KEYS.end() ? KEY_NONE : static_cast<uint8_t>(it - SECTION_KEYS.begin());
+	}
+
+	for (uint8_t field = 0; field < FIELD_COUNT; field++)
+		if (key == GetFieldKey(field))
+			return field;
+	return KEY_NONE;
+}
+
+const char* SceneReader::GetFieldKey(uint8_t field) noexcept
+{
+	static constexpr std::array<const char*, FIELD_COUNT> FIELD_KEYS = {
+		"ID", "Position", "Type", "Name", "Operator", "Value", "Title", "Description", "Input", "Output",
+		"Outputs", "Bubbles", "Expressions", "Prompts", "UUID", "ForNpc", "Objectives", "QuestID", "ObjectiveID",
+		"Succeed", "Comment", "Size", "StartPinID", "EndPinID", "Speaker", "Line", "IsOptional"
+	};
+	return field < FIELD_COUNT ? FIELD_KEYS[field] : "";
+}
+
+bool SceneReader::IsListField(uint8_t field) noexcept
+{
+	switch (field)
+	{
+	case FIELD_POSITION:
+	case FIELD_SIZE:
+	case FIELD_OUTPUTS:
+	case FIELD_PROMPTS:
+	case FIELD_BUBBLES:
+	case FIELD_EXPRESSIONS:
+	case FIELD_OBJECTIVES:
+		return true;
+	default:
+		return false;
+	}
+}
+
+uint32_t SceneReader::GetUsedFields(void) const noexcept
+{
+	static constexpr auto bits = [](std::initializer_list<Field> fields) {
+		uint32_t mask = 0;
+		for (const Field field : fields)
+			mask |= 1u << field;
+		return mask;
+	};
+	static constexpr std::array<uint32_t, SECTION_COUNT> NODE_FIELDS = {
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_OUTPUT }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_TYPE, FIELD_NAME, FIELD_OPERATOR, FIELD_VALUE, FIELD_INPUT, FIELD_OUTPUT }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_TITLE, FIELD_BUBBLES, FIELD_INPUT, FIELD_OUTPUT }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_UUID, FIELD_INPUT, FIELD_OUTPUTS }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_EXPRESSIONS, FIELD_INPUT, FIELD_OUTPUTS }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_PROMPTS, FIELD_INPUT, FIELD_OUTPUTS }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_INPUT, FIELD_OUTPUTS }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_FOR_NPC, FIELD_INPUT, FIELD_OUTPUTS }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_INPUT, FIELD_OUTPUTS }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_UUID, FIELD_TITLE, FIELD_DESCRIPTION, FIELD_OBJECTIVES, FIELD_INPUT, FIELD_OUTPUT }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_QUEST_ID, FIELD_SUCCEED, FIELD_INPUT, FIELD_OUTPUT }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_QUEST_ID, FIELD_OBJECTIVE_ID, FIELD_SUCCEED, FIELD_INPUT, FIELD_OUTPUT }),
+		bits({ FIELD_ID, FIELD_POSITION, FIELD_SIZE, FIELD_COMMENT }),
+		bits({ FIELD_ID, FIELD_START_PIN_ID, FIELD_END_PIN_ID })
+	};
+	static constexpr uint32_t BUBBLE_FIELDS = bits({ FIELD_SPEAKER, FIELD_LINE });
+	static constexpr uint32_t OBJECTIVE_FIELDS = bits({ FIELD_UUID, FIELD_TITLE, FIELD_DESCRIPTION, FIELD_IS_OPTIONAL });
+	static constexpr uint32_t CONDITION_FIELDS = bits({ FIELD_NAME, FIELD_OPERATOR, FIELD_VALUE });
+
+	switch (GetLevel())
+	{
+	case LEVEL_NODE:		return mSection < SECTION_COUNT ? NODE_FIELDS[mSection] : 0;
+	case LEVEL_ITEM:		return GetListField() == FIELD_BUBBLES ? BUBBLE_FIELDS : GetListField() == FIELD_OBJECTIVES ? OBJECTIVE_FIELDS : 0;
+	case LEVEL_CONDITION:	return CONDITION_FIELDS;
+	default:				return 0;
+	}
+}
+
+SceneReader::List* SceneReader::FindList(uint8_t field) noexcept
+{
+	switch (field)
+	{
+	case FIELD_POSITION:	return &mPosition;
+	case FIELD_SIZE:		return &mSize;
+	case FIELD_OUTPUTS:		return &mOutputs;
+	case FIELD_PROMPTS:		return &mPrompts;
+	default:				return nullptr;
+	}
+}
+
+bool SceneReader::BeginCollection(const YAML::Mark& mark, bool isMap)
+{
+	const uint8_t key = mFrames.empty() ? KEY_NONE : mFrames.back().Key;
+	const bool isUsed = key != KEY_NONE && (GetUsedFields() & (1u << key));
+	switch (GetLevel())
+	{
+	case LEVEL_DOCUMENT:
+		if (isMap)
+			throw YAML::RepresentationException(mark, "a .puru file is a sequence of Characters");
+		return true;
+
+	case LEVEL_CHARACTERS:
+		if (!isMap)
+			throw YAML::RepresentationException(mark, "a Character is a map");
+		mCharacter = std::make_unique<CharacterRecord>();
+		mCharacterMark = mark;
+		mHasName = false;
+		return true;
+
+	case LEVEL_CHARACTER:
+		if (key == KEY_NONE)
+			return false;
+		if (key == SECTION_NAME)
+			throw YAML::TypedBadConversion<std::string>(mark);
+		if (isMap)
+			throw YAML::RepresentationException(mark, "a section is a sequence of nodes");
+		mSection = key;
+		return true;
+
+	case LEVEL_SECTION:
+		if (!isMap)
+			throw YAML::RepresentationException(mark, "a node is a map");
+		mNode.Reset(mark);
+		mPosition.Count = mSize.Count = mOutputs.Count = mPrompts.Count = 0;
+		mBubbles.clear();
+		mExpressions.clear();
+		mObjectives.clear();
+		return true;
+
+	case LEVEL_NODE:
+		// Only the first occurrence of a key is read, like a YAML::Node lookup
+		if (!isUsed || mNode.Has(static_cast<Field>(key)))
+			return false;
+		if (isMap || !IsListField(key))
+			throw YAML::BadConversion(mark);
+		mNode.Present |= 1u << key;
+		return true;
+
+	case LEVEL_LIST:
+		if (GetListField() == FIELD_EXPRESSIONS && !isMap)
+		{
+			mExpressions.emplace_back();
+			return true;
+		}
+		if ((GetListField() == FIELD_BUBBLES || GetListField() == FIELD_OBJECTIVES) && isMap)
+		{
+			mItem.Reset(mark);
+			return true;
+		}
+		throw YAML::BadConversion(mark);
+
+	case LEVEL_ITEM:
+		if (!mFrames.back().IsMap)
+		{
+			if (!isMap)
+				throw YAML::RepresentationException(mark, "a condition is a map");
+			mItem.Reset(mark);
+			return true;
+		}
+		[[fallthrough]];
+	case LEVEL_CONDITION:
+		if (!isUsed || mItem.Has(static_cast<Field>(key)))
+			return false;
+		throw YAML::BadConversion(mark);
+
+	default:
+		throw YAML::RepresentationException(mark, "unexpected collection");
+	}
+}
+
+void SceneReader::EndCollection(bool isMap)
+{
+	switch (GetLevel())
+	{
+	case LEVEL_CHARACTERS:
+		if (!mHasName)
+			throw YAML::KeyNotFound(mCharacterMark, std::string("Name"));
+		mOnCharacter(std::move(mCharacter), mOffset);
+		return;
+	case LEVEL_CHARACTER:
+		mSection = KEY_NONE;
+		return;
+	case LEVEL_SECTION:
+		FinishNode();
+		return;
+	case LEVEL_LIST:
+		if (isMap)
+			FinishItem(GetListField());
+		return;
+	case LEVEL_ITEM:
+		FinishCondition();
+		return;
+	default:
+		return;
+	}
+}
+
+void SceneReader::ReadScalar(const YAML::Mark& mark, const std::string& value)
+{
+	const uint8_t key = mFrames.empty() ? KEY_NONE : mFrames.back().Key;
+	const uint32_t bit = key == KEY_NONE ? 0 : 1u << key;
+	switch (GetLevel())
+	{
+	case LEVEL_DOCUMENT:
+		return;//An empty file has no Characters
+
+	case LEVEL_CHARACTERS:
+		throw YAML::RepresentationException(mark, "a Character is a map");
+
+	case LEVEL_CHARACTER:
+		if (key == SECTION_NAME && !mHasName)
+		{
+			mCharacter->Name = value;
+			mHasName = true;
+		}
+		return;//Otherwise a section without nodes or an unknown key
+
+	case LEVEL_SECTION:
+		throw YAML::RepresentationException(mark, "a node is a map");
+
+	case LEVEL_NODE:
+		if (!(GetUsedFields() & bit) || mNode.Has(static_cast<Field>(key)))
+			return;
+		mNode.Present |= bit;
+		if (IsListField(key))
+			return;//Holds no element
+		mNode.Values[key] = value;
+		return;
+
+	case LEVEL_LIST:
+		if (GetListField() == FIELD_EXPRESSIONS)
+		{
+			mExpressions.emplace_back();//An expression without conditions
+			return;
+		}
+		if (List* list = FindList(GetListField()))
+		{
+			list->Add() = value;
+			return;
+		}
+		throw YAML::BadConversion(mark);
+
+	case LEVEL_ITEM:
+		if (!mFrames.back().IsMap)
+			throw YAML::RepresentationException(mark, "a condition is a map");
+		[[fallthrough]];
+	case LEVEL_CONDITION:
+		if (!(GetUsedFields() & bit) || mItem.Has(static_cast<Field>(key)))
+			return;
+		mItem.Present |= bit;
+		mItem.Values[key] = value;
+		return;
+
+	default:
+		return;
+	}
+}
+
+void SceneReader::EndValue(void) noexcept
+{
+	if (!mFrames.empty() && mFrames.back().IsMap)
+		mFrames.back().AwaitingKey = true;
+}
+
+ImVec2 SceneReader::GetVector(uint8_t field) const
+{
+	const List& list = field == FIELD_SIZE ? mSize : mPosition;
+	if (!mNode.Has(static_cast<Field>(field)))
+		throw YAML::KeyNotFound(mNode.Mark, std::string(GetFieldKey(field)));
+	if (list.Count != 2)
+		throw YAML::TypedBadConversion<ImVec2>(mNode.Mark);
+	return { Convert<float>(list.Items[0], mNode.Mark), Convert<float>(list.Items[1], mNode.Mark) };
+}
+
+void SceneReader::FinishNode(void)
+{
+	auto& character = *mCharacter;
+	int32_t& nextID = character.NextID;
+	const YAML::Mark& mark = mNode.Mark;
+	auto output = [this, &mark](size_t index) {
+		return Convert<int32_t>(mOutputs.Get(index, mark), mark);
+	};
+
+	switch (mSection)
+	{
+	case SECTION_ENTRY:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		const int32_t pinId = mNode.As<int32_t>(FIELD_OUTPUT);
+		character.EntryNodes.push_back({ Node{ id }, Pin{ pinId, "", PinKind::Output }, pos });
+		break;
+	}
+	case SECTION_VARIABLE:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		const std::string& type = mNode.Get(FIELD_TYPE);
+
+		auto& [variable, pins, position] = character.VariableNodes.emplace_back();
+		auto readVariable = [this](auto& node) {
+			auto name = mNode.Get(FIELD_NAME);
+			memcpy(node.VariableName, name.c_str(), name.size() + 1);
+			node.Operator = DeserializeSetOperator(mNode.Get(FIELD_OPERATOR));
+			node.Value = mNode.As<decltype(node.Value)>(FIELD_VALUE);
+		};
+		if (type.compare("Boolean") == 0)
+			readVariable(variable.emplace<VariableNode<bool>>(id));
+		else if (type.compare("Integer") == 0)
+			readVariable(variable.emplace<VariableNode<int32_t>>(id));
+
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		const int32_t outputID = mNode.As<int32_t>(FIELD_OUTPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		pins.Output = Pin{ outputID, PinKind::Output };
+		position = pos;
+		nextID = std::max({ inputID, outputID, id, nextID });
+		break;
+	}
+	case SECTION_ACT:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		auto& [act, pins, position] = character.ActNodes.emplace_back(Record<ActNode, InputOutput>{ ActNode{ id }, {}, {} });
+		auto title = mNode.Get(FIELD_TITLE);
+		memcpy(act.Title, title.c_str(), title.size() + 1);
+		act.Bubbles = std::move(mBubbles);
+
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		const int32_t outputID = mNode.As<int32_t>(FIELD_OUTPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		pins.Output = Pin{ outputID, PinKind::Output };
+		position = pos;
+		nextID = std::max({ inputID, outputID, id, nextID });
+		break;
+	}
+	case SECTION_FORK:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		nextID = std::max(id, nextID);
+		const auto pos = GetVector(FIELD_POSITION);
+
+		const gte::uuid uuid = mNode.Get(FIELD_UUID);
+		auto& [fork, pins, position] = character.ForkNodes.emplace_back(Record<ForkNode, ForkInputOutput>{ ForkNode{ id, uuid }, {}, {} });
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		const int32_t outputID0 = output(0);
+		const int32_t outputID1 = output(1);
+
+		pins.Input = Pin{ inputID, PinKind::Input };
+		pins.Outputs[0] = Pin{ outputID0, "Others", PinKind::Output };
+		pins.Outputs[1] = Pin{ outputID1, "First", PinKind::Output };
+		position = pos;
+		nextID = std::max({ inputID, outputID0, outputID1, id, nextID });
+		break;
+	}
+	case SECTION_BRANCH:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		auto& [branch, pins, position] = character.BranchNodes.emplace_back(Record<BranchNode, InputOutputs>{ BranchNode{ id }, {}, {} });
+		branch.Expressions = std::move(mExpressions);
+
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		if (!mNode.Has(FIELD_OUTPUTS))
+			throw YAML::KeyNotFound(mark, std::string(GetFieldKey(FIELD_OUTPUTS)));
+		int32_t maxOutputID = 1;
+		for (size_t i = 0; i < mOutputs.Count; i++)
+		{
+			const int32_t outputID = output(i);
+			pins.Outputs.emplace_back(outputID, "then", PinKind::Output);
+			maxOutputID = std::max(maxOutputID, outputID);
+		}
+		if (!pins.Outputs.empty())
+			pins.Outputs.back().Name = "else";
+		position = pos;
+		nextID = std::max({ inputID, maxOutputID, id, nextID });
+		break;
+	}
+	case SECTION_DIALOGUE:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		auto& [dialogue, pins, position] = character.DialogueNodes.emplace_back(Record<DialogueNode, InputOutputs>{ DialogueNode{ id }, {}, {} });
+		for (size_t i = 0; i < mPrompts.Count; i++)
+			dialogue.Prompts.emplace_back(mPrompts.Items[i]);
+
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		if (!mNode.Has(FIELD_OUTPUTS))
+			throw YAML::KeyNotFound(mark, std::string(GetFieldKey(FIELD_OUTPUTS)));
+		int32_t maxOutputID = 1;
+		for (size_t i = 0; i < mOutputs.Count; i++)
+		{
+			const int32_t outputID = output(i);
+			pins.Outputs.emplace_back(outputID, "", PinKind::Output);
+			maxOutputID = std::max(maxOutputID, outputID);
+		}
+		position = pos;
+		nextID = std::max({ inputID, maxOutputID, id, nextID });
+		break;
+	}
+	case SECTION_FLAVOR_MATCH:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		auto& [flavorMatch, pins, position] = character.FlavorMatchNodes.emplace_back(Record<FlavorMatchNode, ForkInputOutput>{ FlavorMatchNode{ id }, {}, {} });
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		const int32_t outputID0 = output(0);
+		const int32_t outputID1 = output(1);
+
+		pins.Input = Pin{ inputID, PinKind::Input };
+		pins.Outputs[0] = Pin{ outputID0, "Flavor matching", PinKind::Output };
+		pins.Outputs[1] = Pin{ outputID1, "else", PinKind::Output };
+		position = pos;
+		nextID = std::max({ inputID, outputID0, outputID1, id, nextID });
+		break;
+	}
+	case SECTION_FLAVOR_CHECK:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		const bool forNpc = mNode.As<bool>(FIELD_FOR_NPC);
+		auto& [flavorCheck, pins, position] = character.FlavorCheckNodes.emplace_back(Record<FlavorCheckNode, InputOutputs>{ FlavorCheckNode{ id, forNpc }, {}, {} });
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+
+		static constexpr std::array<const char*, 5> FLAVORS = { "Bitter", "Salty", "Sour", "Sweet", "Neutral" };
+		int32_t maxOutputID = inputID;
+		for (size_t i = 0; i < FLAVORS.size(); i++)
+		{
+			const int32_t outputID = output(i);
+			pins.Outputs.emplace_back(outputID, FLAVORS[i], PinKind::Output);
+			maxOutputID = std::max(maxOutputID, outputID);
+		}
+		position = pos;
+		nextID = std::max({ maxOutputID, id, nextID });
+		break;
+	}
+	case SECTION_DICE:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		auto& [dice, pins, position] = character.DiceNodes.emplace_back(Record<DiceNode, InputOutputs>{ DiceNode{ id }, {}, {} });
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		int32_t max = -1;
+		for (size_t i = 0; i < mOutputs.Count; i++)
+		{
+			const int32_t outputID = output(i);
+			max = std::max(max, outputID);
+			pins.Outputs.emplace_back(outputID, PinKind::Output);
+		}
+		position = pos;
+		nextID = std::max({ max, nextID, id, inputID });
+		break;
+	}
+	case SECTION_ACCEPT_QUEST:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		const gte::uuid uuid = mNode.Get(FIELD_UUID);
+		const std::string& title = mNode.Get(FIELD_TITLE);
+		const std::string& description = mNode.Get(FIELD_DESCRIPTION);
+		auto& [quest, pins, position] = character.AcceptQuestNodes.emplace_back(Record<AcceptQuestNode, InputOutput>{ AcceptQuestNode{ id }, {}, {} });
+		quest.UUID = uuid;
+		strcpy(quest.Title, title.c_str());
+		strcpy(quest.Description, description.c_str());
+		quest.Objectives = std::move(mObjectives);
+
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		const int32_t outputID = mNode.As<int32_t>(FIELD_OUTPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		pins.Output = Pin{ outputID, PinKind::Output };
+		position = pos;
+		nextID = std::max({ inputID, outputID, id, nextID });
+		break;
+	}
+	case SECTION_RETURN_QUEST:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		const gte::uuid questID = mNode.Get(FIELD_QUEST_ID);
+		const bool succeed = mNode.Has(FIELD_SUCCEED) ? mNode.As<bool>(FIELD_SUCCEED) : true;
+
+		auto& [quest, pins, position] = character.ReturnQuestNodes.emplace_back(Record<ReturnQuestNode, InputOutput>{ ReturnQuestNode{ id }, {}, {} });
+		quest.QuestID = questID;
+		quest.Succeed = succeed;
+
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		const int32_t outputID = mNode.As<int32_t>(FIELD_OUTPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		pins.Output = Pin{ outputID, PinKind::Output };
+		position = pos;
+		nextID = std::max({ inputID, outputID, id, nextID });
+		break;
+	}
+	case SECTION_OBJECTIVE:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		const gte::uuid questID = mNode.Get(FIELD_QUEST_ID);
+		const gte::uuid objectiveID = mNode.Get(FIELD_OBJECTIVE_ID);
+		const bool succeed = mNode.Has(FIELD_SUCCEED) ? mNode.As<bool>(FIELD_SUCCEED) : true;
+
+		auto& [objective, pins, position] = character.ObjectiveNodes.emplace_back(Record<ObjectiveNode, InputOutput>{ ObjectiveNode{ id }, {}, {} });
+		objective.QuestID = questID;
+		objective.ObjectiveID = objectiveID;
+		objective.Succeed = succeed;
+
+		const int32_t inputID = mNode.As<int32_t>(FIELD_INPUT);
+		const int32_t outputID = mNode.As<int32_t>(FIELD_OUTPUT);
+		pins.Input = Pin{ inputID, PinKind::Input };
+		pins.Output = Pin{ outputID, PinKind::Output };
+		position = pos;
+		nextID = std::max({ inputID, outputID, id, nextID });
+		break;
+	}
+	case SECTION_COMMENT:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		const auto pos = GetVector(FIELD_POSITION);
+		const auto size = GetVector(FIELD_SIZE);
+		auto& [comment, pins, position] = character.Comments.emplace_back(Record<CommentNode>{ CommentNode{ id }, {}, {} });
+		comment.Comment = mNode.Get(FIELD_COMMENT);
+		comment.Size = size;
+		position = pos;
+		nextID = std::max({ nextID, id });
+		break;
+	}
+	case SECTION_LINK:
+	{
+		const int32_t id = mNode.As<int32_t>(FIELD_ID);
+		nextID = std::max(id, nextID);
+		const int32_t start = mNode.As<int32_t>(FIELD_START_PIN_ID);
+		const int32_t end = mNode.As<int32_t>(FIELD_END_PIN_ID);
+		character.Links.emplace_back(id, start, end);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void SceneReader::FinishItem(uint8_t listField)
+{
+	if (listField == FIELD_BUBBLES)
+	{
+		mBubbles.emplace_back(DeserializeSpeaker(mItem.Get(FIELD_SPEAKER)), mItem.Get(FIELD_LINE));
+	}
+	else if (listField == FIELD_OBJECTIVES)
+	{
+		const gte::uuid uuid = mItem.Get(FIELD_UUID);
+		const std::string& title = mItem.Get(FIELD_TITLE);
+		const std::string& description = mItem.Get(FIELD_DESCRIPTION);
+		const bool isOptional = mItem.As<bool>(FIELD_IS_OPTIONAL);
+		auto& objective = mObjectives.emplace_back();
+		objective.UUID = uuid;
+		strcpy(objective.Title, title.c_str());
+		strcpy(objective.Description, description.c_str());
+		objective.IsOptional = isOptional;
+	}
+}
+
+void SceneReader::FinishCondition(void)
+{
+	auto& condition = mExpressions.back().emplace_back();
+	const std::string& name = mItem.Get(FIELD_NAME);
+	memcpy(condition.VariableName, name.c_str(), name.size() + 1);
+	condition.Operator = DeserializeCompareOperator(mItem.Get(FIELD_OPERATOR));
+	condition.Value = mItem.As<int32_t>(FIELD_VALUE);
+}
+
+SetOperator DeserializeSetOperator(const std::string& pOperator)
+{
+	if (pOperator.compare("=") == 0)		return SetOperator::Assignment;
+	else if (pOperator.compare("+=") == 0)	return SetOperator::Add;
+	else if (pOperator.compare("-=") == 0)	return SetOperator::Subtract;
+	else if (pOperator.compare("*=") == 0)	return SetOperator::Multiple;
+	else if (pOperator.compare("/=") == 0)	return SetOperator::Divide;
+	return SetOperator::Assignment;//Shouldn't be reached
+}
+
+CompareOperator DeserializeCompareOperator(const std::string& pOperator)
+{
+	if (pOperator.compare("==") == 0)		return CompareOperator::Equality;
+	else if (pOperator.compare(">") == 0)	return CompareOperator::Greater;
+	else if (pOperator.compare("<") == 0)	return CompareOperator::Less;
+	else if (pOperator.compare(">=") == 0)	return CompareOperator::GreaterEquals;
+	else if (pOperator.compare("<=") == 0)	return CompareOperator::LessEquals;
+	else if (pOperator.compare("<>") == 0)	return CompareOperator::Different;
+	return CompareOperator::Equality;//Shouldn't be reached
+}
+
+Speaker DeserializeSpeaker(const std::string& pSpeaker)
+{
+	if (pSpeaker.compare("MainCharacter") == 0)	return Speaker::MainCharacter;
+	else if (pSpeaker.compare("NPC") == 0)		return Speaker::NPC;
+	else if (pSpeaker.compare("Internal") == 0) return Speaker::Internal;
+	else//Should not reach here
+		return Speaker::Internal;
+}
@@ -0,0 +1,143 @@
+#include <Simulator.h>
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <bit>
+#include <future>
+#include <limits>
+
+// Progress is published in batches so workers don't fight over the atomics
+static constexpr uint64_t PROGRESS_BATCH = 1024;
+
+// Flavors a Character can be given in the editor, combinations never come out of a FlavorCheck
+static constexpr uint32_t FLAVOR_COUNT = static_cast<uint32_t>(Flavor::Neutral) + 1;
+
+void Simulator::Report::Merge(const Report& other)
+{
+	if (other.Runs == 0)
+		return;
+
+	MinLength = Runs == 0 ? other.MinLength : std::min(MinLength, other.MinLength);
+	MaxLength = std::max(MaxLength, other.MaxLength);
+	Runs += other.Runs;
+	Cut += other.Cut;
+	Steps += other.Steps;
+	for (size_t i = 0; i < Lengths.size(); i++)
+		Lengths[i] += other.Lengths[i];
+
+	auto add = [](std::vector<uint64_t>& lhs, const std::vector<uint64_t>& rhs) {
+		lhs.resize(std::max(lhs.size(), rhs.size()), 0);
+		for (size_t i = 0; i < rhs.size(); i++)
+			lhs[i] += rhs[i];
+	};
+	add(Visits, other.Visits);
+	add(Ends, other.Ends);
+	add(Taken, other.Taken);
+}
+
+[[nodiscard]] Simulator::Report Simulator::Run(const DialogueProgram& program, const StateMachine& initial, const Settings& settings, Progress* progress)
+{
+	Report report;
+	report.Visits.assign(program.Size(), 0);
+	report.Ends.assign(program.Size(), 0);
+	if (program.Size() > 0)
+	{
+		const auto& last = program.GetInstruction(static_cast<uint32_t>(program.Size() - 1));
+		report.Taken.assign(last.FirstSuccessor + last.SuccessorCount, 0);
+	}
+	if (program.GetEntry() == DialogueProgram::END || settings.Runs == 0)
+		return report;
+
+	const uint64_t seed = settings.Seed != 0 ? settings.Seed : Random::RandomSeed();
+	const size_t threadCount = static_cast<size_t>(std::min<uint64_t>(settings.ThreadCount == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : settings.ThreadCount, settings.Runs));
+	if (threadCount <= 1)
+	{
+		Play(program, initial, settings.Runs, settings.MaxSteps, seed, 0, report, progress);
+		return report;
+	}
+
+	// Every worker gets an even share of the playthroughs and a report of its own, merged in order
+	ThreadPool pool(threadCount);
+	std::vector<Report> reports(threadCount, report);
+	std::vector<std::future<void>> pending;
+	pending.reserve(threadCount);
+	for (size_t worker = 0; worker < threadCount; worker++)
+	{
+		const uint64_t runs = settings.Runs / threadCount + (worker < settings.Runs % threadCount ? 1 : 0);
+		pending.emplace_back(pool.Submit([&, runs, worker]() {
+			Play(program, initial, runs, settings.MaxSteps, seed, worker, reports[worker], progress);
+		}));
+	}
+
+	for (size_t worker = 0; worker < threadCount; worker++)
+	{
+		pending[worker].get();
+		report.Merge(reports[worker]);
+	}
+	return report;
+}
+
+void Simulator::Play(const DialogueProgram& program, const StateMachine& initial, uint64_t runs, uint32_t maxSteps, uint64_t seed, size_t worker, Report& report, Progress* progress)
+{
+	StateMachine state = initial;
+	Random random(seed, worker);
+
+	uint32_t minLength = std::numeric_limits<uint32_t>::max();
+	uint32_t maxLength = 0;
+	uint64_t done = 0;
+	while (done < runs)
+	{
+		state.Restore(initial);
+		// Drawn one after the other, arguments could be evaluated in any order and break replays
+		const auto mainFlavor = static_cast<Flavor>(random.Below(FLAVOR_COUNT));
+		const auto flavors = std::make_pair(mainFlavor, static_cast<Flavor>(random.Below(FLAVOR_COUNT)));
+
+		uint32_t pc = program.GetEntry();
+		uint32_t length = 0;
+		while (true)
+		{
+			if (length == maxSteps)
+			{
+				report.Cut++;
+				break;
+			}
+
+			const auto& instruction = program.GetInstruction(pc);
+			report.Visits[pc]++;
+			length++;
+
+			// The player picks at random too, from the same generator as the dice
+			const bool choosing = instruction.Op == NodeType::Dialogue && instruction.SuccessorCount > 0;
+			const int32_t choice = choosing ? static_cast<int32_t>(random.Below(instruction.SuccessorCount)) : -1;
+			const uint32_t output = program.Execute(pc, state, flavors, random, choice);
+
+			const uint32_t next = output < instruction.SuccessorCount ? program.GetSuccessors(pc)[output] : DialogueProgram::END;
+			if (output < instruction.SuccessorCount)
+				report.Taken[instruction.FirstSuccessor + output]++;
+			if (next == DialogueProgram::END)
+			{
+				report.Ends[pc]++;
+				break;
+			}
+			pc = next;
+		}
+
+		report.Steps += length;
+		report.Lengths[std::bit_width(length)]++;
+		minLength = std::min(minLength, length);
+		maxLength = std::max(maxLength, length);
+
+		if (++done % PROGRESS_BATCH == 0 && progress)
+		{
+			progress->Done += PROGRESS_BATCH;
+			if (progress->Cancelled)
+				break;
+		}
+	}
+
+	if (progress)
+		progress->Done += done % PROGRESS_BATCH;
+	report.Runs = done;
+	report.MinLength = done == 0 ? 0 : minLength;
+	report.MaxLength = maxLength;
+}
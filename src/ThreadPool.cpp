@@ -0,0 +1,41 @@
+#include <ThreadPool.h>
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	mWorkers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+		mWorkers.emplace_back(&ThreadPool::Work, this);
+}
+
+ThreadPool::~ThreadPool(void) noexcept
+{
+	{
+		std::lock_guard lock(mMutex);
+		mStopping = true;
+	}
+	mCondition.notify_all();
+	for (auto& worker : mWorkers)
+		worker.join();
+}
+
+void ThreadPool::Work(void)
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mMutex);
+			mCondition.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+			if (mTasks.empty())
+				return;//Only reached when stopping, queued tasks are still drained first
+			task = std::move(mTasks.front());
+			mTasks.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,36 @@
+#ifdef PLATFORM_WINDOWS
+#include <MappedFile.h>
+
+#include <Windows.h>
+
+MappedFile::MappedFile(const std::string& filepath)
+{
+	HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+	mFile = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		return;
+
+	mMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mMapping)
+		return;
+
+	mData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+	if (mData)
+		mSize = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile(void) noexcept
+{
+	if (mData)
+		UnmapViewOfFile(mData);
+	if (mMapping)
+		CloseHandle(mMapping);
+	if (mFile)
+		CloseHandle(mFile);
+}
+
+#endif
@@ -18,9 +18,4 @@ namespace gte {
 	return lhs;
 }
 
-namespace std {
-
-	[[nodiscard]] size_t hash<gte::uuid>::operator()(const gte::uuid& id) const { return std::hash<std::string>()(id.str()); }
-
-}
 #endif
\ No newline at end of file